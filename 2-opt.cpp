@@ -1,64 +1,266 @@
+#include "Solver.h"
 #include "TourModifier.h"
+#include "TourWriter.h"
+#include "batch.h"
+#include "crossover.h"
 #include "fileio.h"
-#include "lateral.h"
-#include "vopt/lateral.h"
-#include "solver.h"
+#include "profile.h"
 
+#include <algorithm> // max
+#include <cstdlib> // EXIT_FAILURE
 #include <iostream>
+#include <memory> // shared_ptr
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
 
-int main(int argc, const char** argv)
+namespace {
+
+void print_progress(const Progress& progress)
 {
-    if (argc < 2)
+    switch (progress.event)
     {
-        std::cout << "Arguments: point_set_file_path optional_tour_file_path" << std::endl;
-        return 0;
+        case Progress::Event::Initial:
+            std::cout << "Initial tour length: " << progress.length << "\n";
+            break;
+        case Progress::Event::Climbed:
+            std::cout << "multi-climb length: " << progress.length << "\n";
+            break;
+        case Progress::Event::LowerBound:
+            std::cout << "Held-Karp lower bound: " << progress.length << "\n";
+            break;
+        case Progress::Event::Backbone:
+            std::cout << "Backbone edges fixed: " << progress.cost << "\n";
+            break;
+        case Progress::Event::PerturbationCost:
+            std::cout << progress.phase << " trying perturbation cost: " << progress.cost << "\n";
+            break;
+        case Progress::Event::Improvement:
+            std::cout << progress.phase << " perturbation improvement: " << progress.length << "\n";
+            break;
+        case Progress::Event::Finished:
+            std::cout << "final length: " << progress.length << std::endl;
+            break;
     }
+}
 
-    // Read input files.
-    const auto coordinates {fileio::read_coordinates(argv[1])};
-    const auto& x {coordinates[0]};
-    const auto& y {coordinates[1]};
-    const auto initial_tour = fileio::initial_tour(argc, argv, x.size());
+void print_usage()
+{
+    std::cout << "Arguments: [options] point_set_file_path optional_tour_file_paths..." << std::endl;
+    std::cout << "    (multiple tours are merged by partition crossover into the initial tour)" << std::endl;
+    std::cout << "       or: [options] --batch manifest_file_or_directory results_file_path optional_thread_count" << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "    --multilevel: build the initial tour by coarsening (ignored if a tour file is given)." << std::endl;
+    std::cout << "    --time-budget seconds: stop perturbing after this long; --multilevel only perturbs coarse levels with a budget." << std::endl;
+    std::cout << "    --target-gap gap: stop once the tour is within gap (e.g. 0.02) of the Held-Karp lower bound (up to 10000 points)." << std::endl;
+    std::cout << "    --tabu-tenure moves: moves of a perturbation trial for which removed edges may not be added back." << std::endl;
+    std::cout << "    --visited-optima count: local optima remembered to skip repeated trials (0 disables)." << std::endl;
+    std::cout << "    --beam-width k: perturb the k shortest non-improving trials of a cost level again (0 disables)." << std::endl;
+    std::cout << "    --beam-depth d: perturbations per beam path (default 2)." << std::endl;
+    std::cout << "    --uncross-min-points n: remove crossing segments before the initial climb of instances with at least n points (default 2000)." << std::endl;
+    std::cout << "    --batch-moves: apply independent improving moves of the initial climb in batches." << std::endl;
+    std::cout << "    --lateral-neighbors k: only search lateral moves that connect points to their k nearest neighbors." << std::endl;
+    std::cout << "    --repair-neighbors k: likewise for the climbs of perturbation trials (default 10, 0 searches all)." << std::endl;
+    std::cout << "    --profile: report calls, time and hardware counters (Linux perf_event_open) per phase at the end." << std::endl;
+    std::cout << "    --backbone climbs: fix the edges common to this many independent climbs while perturbing." << std::endl;
+    std::cout << "    --journal journal_file_path: record all applied moves for replay.out (single instance only)." << std::endl;
+}
 
-    // Initialize tour modifier.
-    TourModifier tour(initial_tour, x, y);
-    const auto initial_tour_length {tour.length()};
-    std::cout << "Initial tour length: " << initial_tour_length << std::endl;
+struct Arguments
+{
+    SolverOptions options;
+    bool batch_mode {false};
+    bool profile {false};
+    std::string journal_path;
+    std::vector<std::string> positional;
+};
 
-    solver::multi_climb(tour);
+Arguments parse_arguments(int argc, const char** argv)
+{
+    Arguments arguments;
+    auto& options {arguments.options};
+    for (int i {1}; i < argc; ++i)
+    {
+        const std::string argument(argv[i]);
+        if (argument == "--batch")
+        {
+            arguments.batch_mode = true;
+        }
+        else if (argument == "--journal" and i + 1 < argc)
+        {
+            arguments.journal_path = argv[++i];
+            options.journal = true;
+        }
+        else if (argument == "--time-budget" and i + 1 < argc)
+        {
+            options.time_budget = std::stod(argv[++i]);
+        }
+        else if (argument == "--target-gap" and i + 1 < argc)
+        {
+            options.target_gap = std::stod(argv[++i]);
+        }
+        else if (argument == "--tabu-tenure" and i + 1 < argc)
+        {
+            options.tabu_tenure = std::stoul(argv[++i]);
+        }
+        else if (argument == "--visited-optima" and i + 1 < argc)
+        {
+            options.visited_optima = std::stoul(argv[++i]);
+        }
+        else if (argument == "--beam-width" and i + 1 < argc)
+        {
+            options.beam_width = std::stoul(argv[++i]);
+        }
+        else if (argument == "--beam-depth" and i + 1 < argc)
+        {
+            options.beam_depth = std::stoul(argv[++i]);
+        }
+        else if (argument == "--uncross-min-points" and i + 1 < argc)
+        {
+            options.uncross_min_points = std::stoul(argv[++i]);
+        }
+        else if (argument == "--batch-moves")
+        {
+            options.batch_moves = true;
+        }
+        else if (argument == "--lateral-neighbors" and i + 1 < argc)
+        {
+            options.lateral_neighbors = std::stoul(argv[++i]);
+        }
+        else if (argument == "--repair-neighbors" and i + 1 < argc)
+        {
+            options.repair_neighbors = std::stoul(argv[++i]);
+        }
+        else if (argument == "--backbone" and i + 1 < argc)
+        {
+            options.backbone_climbs = std::stoul(argv[++i]);
+        }
+        else if (argument == "--profile")
+        {
+            arguments.profile = true;
+        }
+        else if (argument == "--multilevel")
+        {
+            options.multilevel = true;
+        }
+        else
+        {
+            arguments.positional.push_back(argument);
+        }
+    }
+    return arguments;
+}
 
-    // Save result.
-    const auto final_length {tour.length()};
-    if (initial_tour_length > final_length)
+int run_batch(const std::vector<std::string>& arguments, const SolverOptions& options)
+{
+    if (arguments.size() < 2)
     {
-        auto save_file_prefix {fileio::extract_filename(argv[1])};
-        fileio::write_ordered_points(tour.order()
-            , "saves/" + save_file_prefix + "_" + std::to_string(final_length) + ".txt");
+        print_usage();
+        return 0;
     }
+    unsigned thread_count {std::max(std::thread::hardware_concurrency(), 1u)};
+    if (arguments.size() > 2)
+    {
+        std::stringstream thread_count_stream(arguments[2]);
+        int count {0};
+        if (not (thread_count_stream >> count) or not thread_count_stream.eof() or count < 1)
+        {
+            std::cout << __func__ << ": error: thread count must be a positive integer: " << arguments[2] << std::endl;
+            return EXIT_FAILURE;
+        }
+        thread_count = count;
+    }
+    const auto instances {batch::list_instances(arguments[0])};
+    std::cout << "Solving " << instances.size() << " instances on " << thread_count << " threads." << std::endl;
+    auto batch_options {options};
+    batch_options.journal = false;
+    const auto results {batch::solve(instances, batch_options, thread_count)};
+    batch::write_results(results, arguments[1]);
+    for (const auto& result : results)
+    {
+        if (not result.error.empty())
+        {
+            std::cout << "Could not solve " << result.instance << ": " << result.error << std::endl;
+        }
+    }
+    return 0;
+}
+
+} // namespace
 
-    // Perturbation hill-climbing.
-    auto best_tour {tour};
-    bool improving {false};
-    do
+int main(int argc, const char** argv)
+{
+    const auto parsed {parse_arguments(argc, argv)};
+    const auto& options {parsed.options};
+    const auto& arguments {parsed.positional};
+    if (parsed.profile)
     {
-        improving = false;
-        auto new_tour = vopt::lateral::perturbation_climb(best_tour);
-        auto new_length = new_tour.length();
-        if (new_length < best_tour.length())
+        profile::enable();
+    }
+    if (parsed.batch_mode)
+    {
+        const auto status {run_batch(arguments, options)};
+        if (parsed.profile)
         {
-            best_tour = new_tour;
-            improving = true;
-            std::cout << "v-opt perturbation improvement: " << new_length << std::endl;
+            profile::report(std::cout);
         }
-        new_tour = lateral::perturbation_climb(best_tour);
-        new_length = new_tour.length();
-        if (new_length < best_tour.length())
+        return status;
+    }
+    if (arguments.empty())
+    {
+        print_usage();
+        return 0;
+    }
+
+    // Read input files.
+    const auto& point_set_file_path {arguments[0]};
+    std::vector<primitives::space_t> x, y;
+    std::shared_ptr<const DistanceMatrix> matrix;
+    fileio::read_instance(point_set_file_path.c_str(), x, y, matrix);
+
+    // Intermediate and final tours are saved in the background.
+    const auto save_file_prefix {"saves/" + fileio::extract_filename(point_set_file_path.c_str()) + "_"};
+    TourWriter writer;
+    Solver solver(x, y, options);
+    solver.set_matrix(matrix);
+    solver.set_progress_callback(print_progress);
+    solver.set_tour_callback([&writer, &save_file_prefix](auto ordered_points, auto length)
+    {
+        writer.save(std::move(ordered_points), save_file_prefix + std::to_string(length) + ".txt");
+    });
+    if (arguments.size() > 2)
+    {
+        // merge several tours (e.g. local optima of different runs) into the initial tour.
+        std::vector<TourModifier> tours;
+        for (size_t i {1}; i < arguments.size(); ++i)
         {
-            best_tour = new_tour;
-            improving = true;
-            std::cout << "2-opt perturbation improvement: " << new_length << std::endl;
+            tours.emplace_back(fileio::read_ordered_points(arguments[i].c_str()), x, y, matrix);
+            std::cout << "Tour " << i << " length: " << tours.back().length() << std::endl;
         }
-    } while (improving);
-    std::cout << "final length: " << best_tour.length() << std::endl;
+        const auto merged {crossover::merge(tours)};
+        std::cout << "Merged tour length: " << merged.length() << std::endl;
+        solver.solve(merged.order());
+    }
+    else if (arguments.size() > 1)
+    {
+        solver.solve(fileio::read_ordered_points(arguments[1].c_str()));
+    }
+    else
+    {
+        solver.solve();
+    }
+
+    if (options.journal)
+    {
+        solver.journal().write(parsed.journal_path);
+    }
+
+    // Save result.
+    writer.save(solver.tour(), save_file_prefix + std::to_string(solver.length()) + ".txt");
+    if (parsed.profile)
+    {
+        profile::report(std::cout);
+    }
     return 0;
 }
@@ -0,0 +1,78 @@
+#include "Beam.h"
+
+void Beam::reset(size_t width)
+{
+    m_width = width;
+    m_size = 0;
+    if (m_entries.size() < width)
+    {
+        m_entries.resize(width);
+    }
+}
+
+void Beam::offer(const TourModifier& tour, size_t index, const MoveJournal* prefix, const MoveJournal& journal)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_width == 0)
+    {
+        return;
+    }
+    size_t slot {m_size};
+    for (size_t i {0}; i < m_size; ++i)
+    {
+        if (m_entries[i].tour->hash() == tour.hash())
+        {
+            if (m_entries[i].precedes(tour.length(), index))
+            {
+                return;
+            }
+            slot = i;
+            break;
+        }
+    }
+    if (slot == m_size)
+    {
+        if (m_size < m_width)
+        {
+            ++m_size;
+        }
+        else
+        {
+            // replaces the longest tour, if it is longer.
+            size_t last {0};
+            for (size_t i {1}; i < m_size; ++i)
+            {
+                if (m_entries[last].precedes(m_entries[i].tour->length(), m_entries[i].index))
+                {
+                    last = i;
+                }
+            }
+            if (m_entries[last].precedes(tour.length(), index))
+            {
+                return;
+            }
+            slot = last;
+        }
+    }
+    auto& entry {m_entries[slot]};
+    if (entry.tour)
+    {
+        *entry.tour = tour;
+    }
+    else
+    {
+        entry.tour.emplace(tour);
+    }
+    entry.index = index;
+    entry.journal.clear();
+    if (tour.journal())
+    {
+        if (prefix)
+        {
+            entry.journal.append(*prefix);
+        }
+        entry.journal.append(journal);
+    }
+    // trials from this tour record their moves to their own workspace, as for any journaled tour.
+    entry.tour->set_journal(tour.journal() ? &entry.journal : nullptr);
+}
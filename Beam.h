@@ -0,0 +1,48 @@
+#pragma once
+
+// One level of a beam search over lateral perturbations: the shortest trial tours of the level, up to a width,
+// each with the moves that led to it from the original tour. Safe to offer tours from several threads.
+// Ties in length go to the tour offered with the lowest index, so the beam does not depend on thread timing.
+
+#include "MoveJournal.h"
+#include "TourModifier.h"
+#include "primitives.h"
+
+#include <cstddef> // size_t
+#include <mutex>
+#include <optional>
+#include <vector>
+
+class Beam
+{
+public:
+    // Empties the beam, which keeps up to width tours. Allocates only when the width grows.
+    void reset(size_t width);
+
+    // Keeps a copy of tour, offered as the index-th of its level and reached by the moves of prefix (if any)
+    // followed by those of journal, if it is among the width shortest and not kept already.
+    void offer(const TourModifier& tour, size_t index, const MoveJournal* prefix, const MoveJournal& journal);
+
+    size_t size() const { return m_size; }
+    const TourModifier& tour(size_t i) const { return *m_entries[i].tour; }
+    // Moves from the original tour to tour(i), if the original tour is journaled.
+    const MoveJournal& journal(size_t i) const { return m_entries[i].journal; }
+
+private:
+    struct Entry
+    {
+        std::optional<TourModifier> tour;
+        MoveJournal journal;
+        size_t index {0};
+
+        bool precedes(primitives::length_t length, size_t other_index) const
+        {
+            return tour->length() < length or (tour->length() == length and index < other_index);
+        }
+    };
+
+    std::mutex m_mutex;
+    std::vector<Entry> m_entries;
+    size_t m_size {0};
+    size_t m_width {0};
+};
@@ -0,0 +1,111 @@
+#include "DistanceMatrix.h"
+
+#include <algorithm> // max_element
+#include <cstdlib> // abort
+#include <iostream>
+#include <limits>
+#include <string>
+
+std::optional<size_t> DistanceMatrix::weight_count(primitives::point_id_t point_count, const std::string& edge_weight_format)
+{
+    const size_t n {point_count};
+    if (edge_weight_format == "FULL_MATRIX")
+    {
+        return n * n;
+    }
+    if (edge_weight_format == "UPPER_ROW" or edge_weight_format == "LOWER_ROW")
+    {
+        return n * (n - 1) / 2;
+    }
+    if (edge_weight_format == "UPPER_DIAG_ROW" or edge_weight_format == "LOWER_DIAG_ROW")
+    {
+        return n * (n + 1) / 2;
+    }
+    return std::nullopt;
+}
+
+bool DistanceMatrix::fits(const std::vector<primitives::length_t>& weights)
+{
+    return weights.empty() or *std::max_element(weights.cbegin(), weights.cend()) <= std::numeric_limits<uint32_t>::max();
+}
+
+DistanceMatrix DistanceMatrix::from_explicit(primitives::point_id_t point_count
+    , const std::string& edge_weight_format
+    , const std::vector<primitives::length_t>& weights)
+{
+    DistanceMatrix matrix;
+    matrix.m_size = point_count;
+    const auto max_weight {weights.empty() ? 0 : *std::max_element(weights.cbegin(), weights.cend())};
+    if (max_weight <= std::numeric_limits<uint16_t>::max())
+    {
+        matrix.m_short.resize(entry_count(point_count));
+    }
+    else if (max_weight <= std::numeric_limits<uint32_t>::max())
+    {
+        matrix.m_long.resize(entry_count(point_count));
+    }
+    else
+    {
+        std::cout << __func__ << ": error: weights do not fit in 32 bits." << std::endl;
+        std::abort();
+    }
+
+    const auto expected {weight_count(point_count, edge_weight_format)};
+    if (not expected)
+    {
+        std::cout << __func__ << ": error: unsupported EDGE_WEIGHT_FORMAT: " << edge_weight_format << std::endl;
+        std::abort();
+    }
+    if (weights.size() < *expected)
+    {
+        std::cout << __func__ << ": error: expected " << *expected
+            << " weights but read " << weights.size() << "." << std::endl;
+        std::abort();
+    }
+
+    size_t k {0};
+    for (primitives::point_id_t row {0}; row < point_count; ++row)
+    {
+        primitives::point_id_t begin {0};
+        primitives::point_id_t end {point_count};
+        if (edge_weight_format == "UPPER_ROW")
+        {
+            begin = row + 1;
+        }
+        else if (edge_weight_format == "UPPER_DIAG_ROW")
+        {
+            begin = row;
+        }
+        else if (edge_weight_format == "LOWER_ROW")
+        {
+            end = row;
+        }
+        else if (edge_weight_format == "LOWER_DIAG_ROW")
+        {
+            end = row + 1;
+        }
+        for (auto column {begin}; column < end; ++column)
+        {
+            const auto weight {weights[k++]};
+            // FULL_MATRIX: the lower triangle alone defines the (symmetric) matrix.
+            if (column < row or (column > row and edge_weight_format != "FULL_MATRIX"))
+            {
+                matrix.set(row, column, weight);
+            }
+        }
+    }
+    return matrix;
+}
+
+void DistanceMatrix::set(primitives::point_id_t a, primitives::point_id_t b, primitives::length_t length)
+{
+    const auto i {index(a, b)};
+    if (m_short.empty())
+    {
+        m_long[i] = length;
+    }
+    else
+    {
+        m_short[i] = length;
+    }
+}
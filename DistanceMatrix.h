@@ -0,0 +1,63 @@
+#pragma once
+
+// Lengths between all point pairs of a TSPLIB EXPLICIT instance (coordinate instances compute them instead).
+// Lengths are symmetric, so only the lower triangle (with the diagonal) is stored,
+// in 16 bits when they all fit, otherwise in 32 bits.
+
+#include "primitives.h"
+
+#include <algorithm> // minmax
+#include <cmath> // sqrt
+#include <cstddef> // size_t
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+class DistanceMatrix
+{
+public:
+    // Rounded Euclidean length, as used for coordinate instances.
+    static primitives::length_t rounded_length(primitives::space_t dx, primitives::space_t dy)
+    {
+        auto exact = std::sqrt(dx * dx + dy * dy);
+        return exact + 0.5; // return type cast.
+    }
+
+    // Takes the lengths of a TSPLIB EXPLICIT instance, listed as in edge_weight_format
+    // (FULL_MATRIX, UPPER_ROW, LOWER_ROW, UPPER_DIAG_ROW or LOWER_DIAG_ROW).
+    static DistanceMatrix from_explicit(primitives::point_id_t point_count
+        , const std::string& edge_weight_format
+        , const std::vector<primitives::length_t>& weights);
+
+    // Number of weights edge_weight_format lists for point_count points, if it is supported.
+    static std::optional<size_t> weight_count(primitives::point_id_t point_count, const std::string& edge_weight_format);
+    // Whether from_explicit can store the weights (in at most 32 bits).
+    static bool fits(const std::vector<primitives::length_t>& weights);
+
+    primitives::point_id_t size() const { return m_size; }
+
+    primitives::length_t length(primitives::point_id_t a, primitives::point_id_t b) const
+    {
+        const auto i {index(a, b)};
+        return m_short.empty() ? m_long[i] : m_short[i];
+    }
+
+private:
+    primitives::point_id_t m_size {0};
+    std::vector<uint16_t> m_short;
+    std::vector<uint32_t> m_long;
+
+    static size_t entry_count(primitives::point_id_t point_count)
+    {
+        return static_cast<size_t>(point_count) * (point_count + 1) / 2;
+    }
+    // row max(a, b), column min(a, b) of the lower triangle.
+    static size_t index(primitives::point_id_t a, primitives::point_id_t b)
+    {
+        const auto [column, row] {std::minmax(a, b)};
+        return static_cast<size_t>(row) * (row + 1) / 2 + column;
+    }
+    // sets both (a, b) and (b, a).
+    void set(primitives::point_id_t a, primitives::point_id_t b, primitives::length_t length);
+};
@@ -0,0 +1,120 @@
+#include "DynamicPointGrid.h"
+
+#include <algorithm> // find, max, min, min_element, max_element
+#include <cmath> // sqrt
+
+DynamicPointGrid::DynamicPointGrid(const std::vector<primitives::space_t>& x
+    , const std::vector<primitives::space_t>& y
+    , primitives::point_id_t points_per_cell)
+    : m_x(x)
+    , m_y(y)
+{
+    if (not x.empty())
+    {
+        m_min_x = *std::min_element(x.cbegin(), x.cend());
+        m_min_y = *std::min_element(y.cbegin(), y.cend());
+        const auto width {*std::max_element(x.cbegin(), x.cend()) - m_min_x};
+        const auto height {*std::max_element(y.cbegin(), y.cend()) - m_min_y};
+        const auto cell_count {std::max<primitives::space_t>(1, x.size() / std::max<primitives::point_id_t>(points_per_cell, 1))};
+        m_cell_size = std::sqrt(width * height / cell_count);
+        m_cell_size = std::max(m_cell_size, std::max(width, height) / cell_count);
+        if (not (m_cell_size > 0))
+        {
+            m_cell_size = 1;
+        }
+        m_columns = static_cast<int>(width / m_cell_size) + 1;
+        m_rows = static_cast<int>(height / m_cell_size) + 1;
+    }
+    m_cells.resize(m_columns * m_rows);
+    for (primitives::point_id_t i {0}; i < x.size(); ++i)
+    {
+        insert(i);
+    }
+}
+
+void DynamicPointGrid::insert(primitives::point_id_t i)
+{
+    cell_of(i).push_back(i);
+}
+
+void DynamicPointGrid::erase(primitives::point_id_t i)
+{
+    auto& cell {cell_of(i)};
+    const auto it {std::find(cell.begin(), cell.end(), i)};
+    if (it != cell.end())
+    {
+        *it = cell.back();
+        cell.pop_back();
+    }
+}
+
+int DynamicPointGrid::column(primitives::space_t x) const
+{
+    return std::max(0, std::min(m_columns - 1, static_cast<int>((x - m_min_x) / m_cell_size)));
+}
+
+int DynamicPointGrid::row(primitives::space_t y) const
+{
+    return std::max(0, std::min(m_rows - 1, static_cast<int>((y - m_min_y) / m_cell_size)));
+}
+
+void DynamicPointGrid::nearest(primitives::space_t x
+    , primitives::space_t y
+    , primitives::point_id_t k
+    , std::vector<primitives::point_id_t>& neighbors) const
+{
+    neighbors.clear();
+    auto squared_distance = [this, x, y](primitives::point_id_t j)
+    {
+        const auto dx {m_x[j] - x};
+        const auto dy {m_y[j] - y};
+        return dx * dx + dy * dy;
+    };
+    const int c {column(x)};
+    const int r {row(y)};
+    const int max_ring {std::max(m_columns, m_rows)};
+    for (int ring {0}; ring <= max_ring and k > 0; ++ring)
+    {
+        for (int row {r - ring}; row <= r + ring; ++row)
+        {
+            if (row < 0 or row >= m_rows)
+            {
+                continue;
+            }
+            const bool edge_row {row == r - ring or row == r + ring};
+            const int step {edge_row ? 1 : 2 * ring};
+            for (int column {c - ring}; column <= c + ring; column += step)
+            {
+                if (column < 0 or column >= m_columns)
+                {
+                    continue;
+                }
+                for (auto j : m_cells[row * m_columns + column])
+                {
+                    const auto distance {squared_distance(j)};
+                    if (neighbors.size() == k and distance >= squared_distance(neighbors.back()))
+                    {
+                        continue;
+                    }
+                    if (neighbors.size() == k)
+                    {
+                        neighbors.pop_back();
+                    }
+                    auto position {neighbors.end()};
+                    while (position != neighbors.begin() and squared_distance(*(position - 1)) > distance)
+                    {
+                        --position;
+                    }
+                    neighbors.insert(position, j);
+                }
+            }
+        }
+        // points in further rings are at least ring * m_cell_size away, also from points outside the grid,
+        // as those only lie beyond the border cells.
+        const auto ring_distance {ring * m_cell_size};
+        if (neighbors.size() == k and squared_distance(neighbors.back()) <= ring_distance * ring_distance)
+        {
+            break;
+        }
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+// Uniform grid over a changing point set for nearest-neighbor queries (see PointGrid for static sets).
+// The cell size is fixed by the initial points; points outside their bounding box go into the border cells.
+// Holds references to the coordinates, which must outlive the grid;
+// a point must be erased before its coordinates change and inserted after.
+
+#include "primitives.h"
+
+#include <vector>
+
+class DynamicPointGrid
+{
+public:
+    DynamicPointGrid(const std::vector<primitives::space_t>& x
+        , const std::vector<primitives::space_t>& y
+        , primitives::point_id_t points_per_cell = 2);
+
+    void insert(primitives::point_id_t i);
+    void erase(primitives::point_id_t i);
+
+    // Replaces neighbors with the (up to) k nearest points to (x, y), nearest first.
+    void nearest(primitives::space_t x
+        , primitives::space_t y
+        , primitives::point_id_t k
+        , std::vector<primitives::point_id_t>& neighbors) const;
+
+private:
+    const std::vector<primitives::space_t>& m_x;
+    const std::vector<primitives::space_t>& m_y;
+    primitives::space_t m_min_x {0};
+    primitives::space_t m_min_y {0};
+    primitives::space_t m_cell_size {1};
+    int m_columns {1};
+    int m_rows {1};
+    std::vector<std::vector<primitives::point_id_t>> m_cells;
+
+    int column(primitives::space_t x) const;
+    int row(primitives::space_t y) const;
+    std::vector<primitives::point_id_t>& cell_of(primitives::point_id_t i)
+    {
+        return m_cells[row(m_y[i]) * m_columns + column(m_x[i])];
+    }
+};
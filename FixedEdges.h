@@ -0,0 +1,51 @@
+#pragma once
+
+// Edges that moves may not remove (e.g. the backbone shared by several local optima, see backbone.h).
+// Fixed edges are edges of a tour, so every point has at most two; shared by copies of the tour.
+
+#include "constants.h"
+#include "primitives.h"
+
+#include <array>
+#include <cstdlib> // abort
+#include <iostream>
+#include <vector>
+
+class FixedEdges
+{
+public:
+    FixedEdges(primitives::point_id_t point_count)
+        : m_adjacents(point_count, {constants::invalid_point, constants::invalid_point}) {}
+
+    void add(primitives::point_id_t a, primitives::point_id_t b)
+    {
+        fill(a, b);
+        fill(b, a);
+        ++m_size;
+    }
+
+    bool contains(primitives::point_id_t a, primitives::point_id_t b) const
+    {
+        return m_adjacents[a][0] == b or m_adjacents[a][1] == b;
+    }
+
+    primitives::point_id_t size() const { return m_size; } // edge count.
+
+private:
+    std::vector<std::array<primitives::point_id_t, 2>> m_adjacents;
+    primitives::point_id_t m_size {0};
+
+    void fill(primitives::point_id_t point, primitives::point_id_t adjacent)
+    {
+        for (auto& slot : m_adjacents[point])
+        {
+            if (slot == constants::invalid_point)
+            {
+                slot = adjacent;
+                return;
+            }
+        }
+        std::cout << __func__ << ": error: a point can have at most two fixed edges." << std::endl;
+        std::abort();
+    }
+};
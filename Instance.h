@@ -0,0 +1,59 @@
+#pragma once
+
+// Read-only point set data, shared by all tours (and thus all threads) solving the same instance,
+// so that copying a tour copies only the tour itself.
+
+#include "DistanceMatrix.h"
+#include "PointGrid.h"
+#include "primitives.h"
+
+#include <memory> // shared_ptr
+#include <optional>
+#include <vector>
+
+class Instance
+{
+public:
+    // matrix holds the lengths of an explicit instance; otherwise lengths are the (rounded) distances
+    // between the coordinates, and the points are indexed (see grid)
+    // unless indexed is false (for short-lived instances that keep their own index, see LiveTour).
+    Instance(std::vector<primitives::space_t> x
+        , std::vector<primitives::space_t> y
+        , std::shared_ptr<const DistanceMatrix> matrix = nullptr
+        , bool indexed = true)
+        : m_x(std::move(x))
+        , m_y(std::move(y))
+        , m_matrix(std::move(matrix))
+    {
+        if (not m_matrix and indexed and not m_x.empty())
+        {
+            m_grid.emplace(m_x, m_y);
+        }
+    }
+    // the grid refers to the coordinates.
+    Instance(const Instance&) = delete;
+    Instance& operator=(const Instance&) = delete;
+
+    primitives::point_id_t size() const { return m_x.size(); }
+
+    primitives::length_t length(primitives::point_id_t a, primitives::point_id_t b) const
+    {
+        if (m_matrix)
+        {
+            return m_matrix->length(a, b);
+        }
+        return DistanceMatrix::rounded_length(m_x[a] - m_x[b], m_y[a] - m_y[b]);
+    }
+
+    const std::vector<primitives::space_t>& x() const { return m_x; }
+    const std::vector<primitives::space_t>& y() const { return m_y; }
+    const std::shared_ptr<const DistanceMatrix>& matrix() const { return m_matrix; }
+    // Spatial index of the points, or nullptr if coordinates do not determine lengths (or not indexed).
+    const PointGrid* grid() const { return m_grid ? &*m_grid : nullptr; }
+
+private:
+    const std::vector<primitives::space_t> m_x;
+    const std::vector<primitives::space_t> m_y;
+    const std::shared_ptr<const DistanceMatrix> m_matrix;
+    std::optional<PointGrid> m_grid;
+};
@@ -1,12 +1,17 @@
 #include "LengthMap.h"
 
-LengthMap::LengthMap(const std::vector<primitives::point_id_t>& ordered_points
-    , const std::vector<primitives::space_t>& x
-    , const std::vector<primitives::space_t>& y)
-    : m_x(x)
-    , m_y(y)
-    , m_lengths(ordered_points.size())
+#include <cstdlib> // abort
+#include <iostream>
+
+LengthMap::LengthMap(const std::vector<primitives::point_id_t>& ordered_points, std::shared_ptr<const Instance> instance)
+{
+    reset(ordered_points, std::move(instance));
+}
+
+void LengthMap::reset(const std::vector<primitives::point_id_t>& ordered_points, std::shared_ptr<const Instance> instance)
 {
+    m_instance = std::move(instance);
+    m_lengths.assign(ordered_points.size(), {});
     auto prev {ordered_points.back()};
     for (auto current : ordered_points)
     {
@@ -17,12 +22,35 @@ LengthMap::LengthMap(const std::vector<primitives::point_id_t>& ordered_points
 
 primitives::length_t LengthMap::length(primitives::point_id_t a, primitives::point_id_t b) const
 {
-    return m_lengths[std::min(a, b)].find(std::max(a, b))->second;
+    const auto& entries {m_lengths[std::min(a, b)]};
+    return entries[0].other == std::max(a, b) ? entries[0].length : entries[1].length;
 }
 
 void LengthMap::insert(primitives::point_id_t a, primitives::point_id_t b)
 {
-    auto& map {m_lengths[std::min(a, b)]};
-    map[std::max(a, b)] = compute_length(a, b);
+    auto& entries {m_lengths[std::min(a, b)]};
+    const auto other {std::max(a, b)};
+    Entry* slot {nullptr};
+    for (auto& entry : entries)
+    {
+        if (entry.other == other)
+        {
+            slot = &entry; // already present.
+        }
+    }
+    for (auto& entry : entries)
+    {
+        if (not slot and entry.other == constants::invalid_point)
+        {
+            slot = &entry;
+        }
+    }
+    if (not slot)
+    {
+        std::cout << __func__ << ": error: no available slot for segment." << std::endl;
+        std::cout << a << " -> " << b << std::endl;
+        std::abort();
+    }
+    slot->other = other;
+    slot->length = compute_length(a, b);
 }
-
@@ -1,18 +1,21 @@
 #pragma once
 
+#include "Instance.h"
+#include "constants.h"
 #include "primitives.h"
 
 #include <algorithm> // min, max
-#include <cmath> // sqrt
-#include <unordered_map>
+#include <array>
+#include <memory> // shared_ptr
 #include <vector>
 
 class LengthMap
 {
 public:
-    LengthMap(const std::vector<primitives::point_id_t>& ordered_points
-        , const std::vector<primitives::space_t>& x
-        , const std::vector<primitives::space_t>& y);
+    LengthMap(const std::vector<primitives::point_id_t>& ordered_points, std::shared_ptr<const Instance> instance);
+
+    // Reinitializes for a new tour, reusing allocated storage.
+    void reset(const std::vector<primitives::point_id_t>& ordered_points, std::shared_ptr<const Instance> instance);
 
     primitives::length_t length(primitives::point_id_t a, primitives::point_id_t b) const;
 
@@ -20,27 +23,39 @@ public:
 
     primitives::length_t compute_length(primitives::point_id_t a, primitives::point_id_t b) const
     {
-        auto dx = m_x[a] - m_x[b];
-        auto dy = m_y[a] - m_y[b];
-        auto exact = std::sqrt(dx * dx + dy * dy);
-        return exact + 0.5; // return type cast.
+        return m_instance->length(a, b);
     }
 
     void erase(primitives::point_id_t a, primitives::point_id_t b)
     {
-        m_lengths[std::min(a, b)].erase(std::max(a, b));
+        for (auto& entry : m_lengths[std::min(a, b)])
+        {
+            if (entry.other == std::max(a, b))
+            {
+                entry.other = constants::invalid_point;
+            }
+        }
     }
 
-    const std::vector<primitives::space_t>& x() const { return m_x; }
-    const std::vector<primitives::space_t>& y() const { return m_y; }
+    const std::shared_ptr<const Instance>& instance() const { return m_instance; }
 
-    const primitives::space_t& x(primitives::point_id_t i) const { return m_x[i]; }
-    const primitives::space_t& y(primitives::point_id_t i) const { return m_y[i]; }
+    // For points added to or removed from the end of the instance; new points have no segments.
+    void set_instance(std::shared_ptr<const Instance> instance)
+    {
+        m_instance = std::move(instance);
+        m_lengths.resize(m_instance->size());
+    }
 
 private:
-    std::vector<primitives::space_t> m_x;
-    std::vector<primitives::space_t> m_y;
+    std::shared_ptr<const Instance> m_instance; // shared by copies.
 
-    std::vector<std::unordered_map<primitives::point_id_t, primitives::length_t>> m_lengths;
+    struct Entry
+    {
+        primitives::point_id_t other {constants::invalid_point};
+        primitives::length_t length {0};
+    };
+    // Segments are stored under their smaller point, which can be in at most 2 tour segments.
+    // Fixed slots keep tour copies and moves free of heap allocation.
+    std::vector<std::array<Entry, 2>> m_lengths;
 
 };
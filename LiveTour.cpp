@@ -0,0 +1,109 @@
+#include "LiveTour.h"
+
+#include "DistanceMatrix.h"
+#include "Instance.h"
+#include "constants.h"
+#include "solver.h"
+
+#include <cstdlib> // abort
+#include <iostream>
+
+LiveTour::LiveTour(const std::vector<primitives::point_id_t>& tour
+    , std::vector<primitives::space_t> x
+    , std::vector<primitives::space_t> y
+    , const Operators& operators)
+    : m_x(std::move(x))
+    , m_y(std::move(y))
+    , m_grid(m_x, m_y)
+    , m_tour(tour, m_x, m_y)
+    , m_operators(operators)
+{
+    if (tour.size() < 3)
+    {
+        std::cout << __func__ << ": error: a live tour needs at least 3 points." << std::endl;
+        std::abort();
+    }
+}
+
+primitives::point_id_t LiveTour::insert(primitives::space_t x, primitives::space_t y)
+{
+    auto length = [this, x, y](primitives::point_id_t i)
+    {
+        return DistanceMatrix::rounded_length(m_x[i] - x, m_y[i] - y);
+    };
+    // cheapest of the edges on either side of the nearest points.
+    m_grid.nearest(x, y, neighbor_count, m_neighbors);
+    // detours are compared without subtracting: rounding can make a detour -1 (points on a segment).
+    primitives::point_id_t best_after {constants::invalid_point};
+    primitives::length_t best_added {0};
+    primitives::length_t best_removed {0};
+    for (auto q : m_neighbors)
+    {
+        for (auto after : {m_tour.prev(q), q})
+        {
+            const auto added {length(after) + length(m_tour.next(after))};
+            const auto removed {m_tour.length(after)};
+            if (best_after == constants::invalid_point or added + best_removed < best_added + removed)
+            {
+                best_added = added;
+                best_removed = removed;
+                best_after = after;
+            }
+        }
+    }
+    const primitives::point_id_t p = m_x.size();
+    m_x.push_back(x);
+    m_y.push_back(y);
+    m_grid.insert(p);
+    m_tour.insert(p, best_after, instance());
+    m_queue.reset(size());
+    for (auto i : {p, best_after, m_tour.next(p)})
+    {
+        m_queue.push(i);
+    }
+    climb();
+    return p;
+}
+
+void LiveTour::remove(primitives::point_id_t i)
+{
+    if (size() < 4)
+    {
+        std::cout << __func__ << ": error: a live tour needs at least 3 points." << std::endl;
+        std::abort();
+    }
+    auto before {m_tour.prev(i)};
+    auto after {m_tour.next(i)};
+    const primitives::point_id_t last = m_x.size() - 1;
+    m_grid.erase(i);
+    if (last != i)
+    {
+        m_grid.erase(last);
+        m_x[i] = m_x[last];
+        m_y[i] = m_y[last];
+    }
+    m_x.pop_back();
+    m_y.pop_back();
+    if (last != i)
+    {
+        m_grid.insert(i);
+        before = before == last ? i : before;
+        after = after == last ? i : after;
+    }
+    m_tour.remove(i, instance());
+    m_queue.reset(size());
+    m_queue.push(before);
+    m_queue.push(after);
+    climb();
+}
+
+std::shared_ptr<const Instance> LiveTour::instance() const
+{
+    // without a grid of its own: m_grid already indexes the points.
+    return std::make_shared<const Instance>(m_x, m_y, nullptr, false);
+}
+
+void LiveTour::climb()
+{
+    solver::local_climb(m_tour, m_queue, m_operators);
+}
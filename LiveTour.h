@@ -0,0 +1,53 @@
+#pragma once
+
+// A solved tour that follows a changing point set: points are inserted at their cheapest position
+// and removed by joining their neighbors, after which only the affected neighborhood is climbed,
+// so an update takes milliseconds rather than a full solve. Lengths are computed from coordinates.
+
+#include "DynamicPointGrid.h"
+#include "Operators.h"
+#include "PointQueue.h"
+#include "TourModifier.h"
+#include "primitives.h"
+
+#include <memory> // shared_ptr
+#include <vector>
+
+class LiveTour
+{
+public:
+    // tour is a (preferably optimized) tour of at least 3 points.
+    LiveTour(const std::vector<primitives::point_id_t>& tour
+        , std::vector<primitives::space_t> x
+        , std::vector<primitives::space_t> y
+        , const Operators& operators = {});
+    // the grid refers to the coordinates.
+    LiveTour(const LiveTour&) = delete;
+    LiveTour& operator=(const LiveTour&) = delete;
+
+    // Inserts a point at (x, y) and returns its id, which is the previous size().
+    primitives::point_id_t insert(primitives::space_t x, primitives::space_t y);
+    // Removes point i; the last point takes the id i.
+    void remove(primitives::point_id_t i);
+
+    const TourModifier& tour() const { return m_tour; }
+    primitives::point_id_t size() const { return m_tour.size(); }
+    const std::vector<primitives::space_t>& x() const { return m_x; }
+    const std::vector<primitives::space_t>& y() const { return m_y; }
+
+private:
+    // candidate insertion positions are the edges at the nearest points.
+    static constexpr primitives::point_id_t neighbor_count {8};
+
+    std::vector<primitives::space_t> m_x;
+    std::vector<primitives::space_t> m_y;
+    DynamicPointGrid m_grid;
+    TourModifier m_tour;
+    PointQueue m_queue;
+    Operators m_operators;
+    std::vector<primitives::point_id_t> m_neighbors;
+
+    std::shared_ptr<const Instance> instance() const;
+    // Climbs around the queued points.
+    void climb();
+};
@@ -0,0 +1,82 @@
+#include "MoveJournal.h"
+
+#include <cstdlib> // abort
+#include <cstring> // memcmp
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+constexpr char magic[4] {'L', 'M', 'O', 'J'};
+constexpr uint32_t version {1};
+
+template <typename T>
+void write_value(std::ofstream& file, const T& value)
+{
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+T read_value(std::ifstream& file)
+{
+    T value {};
+    file.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return value;
+}
+
+} // namespace
+
+void MoveJournal::write(const std::string& file_path) const
+{
+    std::ofstream file(file_path, std::ios::binary);
+    if (not file.is_open())
+    {
+        std::cout << __func__ << ": error: could not open journal file: " << file_path << std::endl;
+        return;
+    }
+    // pack records into one buffer so the file is written in a single call.
+    constexpr size_t record_size {sizeof(uint8_t) + 2 * sizeof(primitives::point_id_t)};
+    std::vector<char> buffer(m_entries.size() * record_size);
+    auto* out {buffer.data()};
+    for (const auto& entry : m_entries)
+    {
+        *out++ = static_cast<char>(entry.kind);
+        std::memcpy(out, &entry.a, sizeof(entry.a));
+        out += sizeof(entry.a);
+        std::memcpy(out, &entry.b, sizeof(entry.b));
+        out += sizeof(entry.b);
+    }
+    file.write(magic, sizeof(magic));
+    write_value(file, version);
+    write_value(file, static_cast<uint32_t>(m_initial_tour.size()));
+    file.write(reinterpret_cast<const char*>(m_initial_tour.data()), m_initial_tour.size() * sizeof(primitives::point_id_t));
+    file.write(buffer.data(), buffer.size());
+}
+
+MoveJournal MoveJournal::read(const std::string& file_path)
+{
+    std::ifstream file(file_path, std::ios::binary);
+    char file_magic[sizeof(magic)] {};
+    file.read(file_magic, sizeof(file_magic));
+    if (not file.is_open() or std::memcmp(file_magic, magic, sizeof(magic)) != 0 or read_value<uint32_t>(file) != version)
+    {
+        std::cout << __func__ << ": error: not a version " << version << " journal file: " << file_path << std::endl;
+        std::abort();
+    }
+    MoveJournal journal;
+    journal.m_initial_tour.resize(read_value<uint32_t>(file));
+    file.read(reinterpret_cast<char*>(journal.m_initial_tour.data())
+        , journal.m_initial_tour.size() * sizeof(primitives::point_id_t));
+    while (true)
+    {
+        const auto kind {read_value<uint8_t>(file)};
+        const auto a {read_value<primitives::point_id_t>(file)};
+        const auto b {read_value<primitives::point_id_t>(file)};
+        if (not file)
+        {
+            break;
+        }
+        journal.m_entries.push_back({static_cast<Kind>(kind), a, b});
+    }
+    return journal;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+// Record of the moves applied to a tour, for replaying a run offline.
+// Binary file layout (native byte order):
+//     "LMOJ", uint32 version, uint32 point count, uint32 point ids of the initial tour,
+//     then one record per move: uint8 kind, uint32 first point, uint32 second point.
+
+#include "primitives.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class MoveJournal
+{
+public:
+    enum class Kind : uint8_t
+    {
+        Move = 0, // TourModifier::move(a, b).
+        VMove = 1 // TourModifier::vmove(a, b).
+    };
+    struct Entry
+    {
+        Kind kind {Kind::Move};
+        primitives::point_id_t a {0};
+        primitives::point_id_t b {0};
+    };
+
+    // Starts a new journal from the given tour.
+    void start(const std::vector<primitives::point_id_t>& initial_tour)
+    {
+        m_initial_tour = initial_tour;
+        m_entries.clear();
+    }
+
+    void record(Kind kind, primitives::point_id_t a, primitives::point_id_t b) { m_entries.push_back({kind, a, b}); }
+    void append(const MoveJournal& other) { m_entries.insert(m_entries.end(), other.m_entries.cbegin(), other.m_entries.cend()); }
+    void clear() { m_entries.clear(); } // keeps the initial tour.
+
+    const std::vector<primitives::point_id_t>& initial_tour() const { return m_initial_tour; }
+    const std::vector<Entry>& entries() const { return m_entries; }
+
+    void write(const std::string& file_path) const;
+    static MoveJournal read(const std::string& file_path);
+
+private:
+    std::vector<primitives::point_id_t> m_initial_tour;
+    std::vector<Entry> m_entries;
+};
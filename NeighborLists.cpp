@@ -0,0 +1,44 @@
+#include "NeighborLists.h"
+
+#include <algorithm> // copy, min, partial_sort
+#include <numeric> // iota
+#include <utility> // pair
+
+void NeighborLists::build(const Instance& instance, primitives::point_id_t k)
+{
+    m_size = instance.size();
+    m_count = m_size == 0 ? 0 : std::min(k, m_size - 1);
+    m_neighbors.resize(static_cast<size_t>(m_size) * m_count);
+    if (m_count == 0)
+    {
+        return;
+    }
+    if (const auto* grid {instance.grid()})
+    {
+        std::vector<primitives::point_id_t> nearest;
+        for (primitives::point_id_t i {0}; i < m_size; ++i)
+        {
+            grid->nearest(i, m_count, nearest);
+            std::copy(nearest.cbegin(), nearest.cend(), m_neighbors.begin() + static_cast<size_t>(i) * m_count);
+        }
+        return;
+    }
+    // explicit lengths: sort every row (ties by point id).
+    std::vector<std::pair<primitives::length_t, primitives::point_id_t>> row;
+    for (primitives::point_id_t i {0}; i < m_size; ++i)
+    {
+        row.clear();
+        for (primitives::point_id_t j {0}; j < m_size; ++j)
+        {
+            if (j != i)
+            {
+                row.push_back({instance.length(i, j), j});
+            }
+        }
+        std::partial_sort(row.begin(), row.begin() + m_count, row.end());
+        for (primitives::point_id_t n {0}; n < m_count; ++n)
+        {
+            m_neighbors[static_cast<size_t>(i) * m_count + n] = row[n].second;
+        }
+    }
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+// The k nearest neighbors of every point of an instance, for restricting lateral moves to those adding
+// a segment between a point and one of its neighbors (see find_moves in OperatorSet.h): cheap moves
+// nearly always connect nearby points, and this makes finding the moves of a cost level O(nk) instead of O(n^2).
+
+#include "Instance.h"
+#include "primitives.h"
+
+#include <vector>
+
+class NeighborLists
+{
+public:
+    // Rebuilds the lists for instance, through its grid if it has one and else from its lengths.
+    void build(const Instance& instance, primitives::point_id_t k);
+
+    primitives::point_id_t size() const { return m_size; } // point count.
+    primitives::point_id_t count() const { return m_count; } // neighbors per point.
+    // count() neighbors of i, nearest first.
+    const primitives::point_id_t* of(primitives::point_id_t i) const { return &m_neighbors[i * m_count]; }
+
+private:
+    primitives::point_id_t m_size {0};
+    primitives::point_id_t m_count {0};
+    std::vector<primitives::point_id_t> m_neighbors;
+};
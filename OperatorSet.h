@@ -0,0 +1,48 @@
+#pragma once
+
+// Compile-time list of move operators, in the order they are tried.
+// Climbs and perturbations are templates over operator sets, so each set gets its own instantiation
+// with all operator calls inlined; a fixed set can also be compiled alone (e.g. a 2-opt-only binary).
+//
+// An operator is a type with only static members:
+//     Move: move with an improvement member (0 for no move).
+//     name: for progress reports.
+//     removed_edge_count: edges removed by one move.
+//     first_improvement(tour): first improving move anywhere.
+//     batch_improvements(tour, moves): fills moves with improving moves that can be applied as one batch
+//         (see TourModifier::begin_batch).
+//     point_improvement(tour, i, allowed, neighbors): first improving move around point i for which allowed(move)
+//         is true; given neighbor lists, only moves adding a segment between i and one of its neighbors count.
+//     apply(tour, move).
+//     for_each_endpoint(tour, move, visit): visits the points whose neighborhood move changes (before applying it).
+//     for_each_removed_edge(tour, move, visit), for_each_added_edge(tour, move, visit):
+//         visit(a, b) for each edge move removes or adds (before applying it).
+//     find_moves(tour, cost, next_cost, moves, neighbors): fills moves with all moves of the given cost,
+//         lowering next_cost to the cheapest cost above it; given neighbor lists (see NeighborLists),
+//         only moves adding a segment between a point and one of its neighbors count.
+
+#include "Operators.h"
+#include "twoopt/Operator.h"
+#include "vopt/Operator.h"
+
+template <typename... Operator>
+struct OperatorSet {};
+
+// Calls f with the set of operators enabled at run time, 2-opt before v-opt, and returns its result.
+template <typename F>
+auto with_operators(const Operators& operators, const F& f)
+{
+    if (operators.two_opt and operators.vopt)
+    {
+        return f(OperatorSet<twoopt::Operator, vopt::Operator>{});
+    }
+    if (operators.two_opt)
+    {
+        return f(OperatorSet<twoopt::Operator>{});
+    }
+    if (operators.vopt)
+    {
+        return f(OperatorSet<vopt::Operator>{});
+    }
+    return f(OperatorSet<>{});
+}
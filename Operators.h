@@ -0,0 +1,9 @@
+#pragma once
+
+// Move operators enabled for climbs and perturbations.
+
+struct Operators
+{
+    bool two_opt {true};
+    bool vopt {true};
+};
@@ -0,0 +1,25 @@
+#include "OptimaCache.h"
+
+OptimaCache::OptimaCache(size_t capacity)
+{
+    if (capacity == 0)
+    {
+        return;
+    }
+    size_t size {1};
+    while (size < capacity)
+    {
+        size *= 2;
+        --m_shift;
+    }
+    m_slots = std::vector<std::atomic<uint64_t>>(size);
+    clear();
+}
+
+void OptimaCache::clear()
+{
+    for (auto& slot : m_slots)
+    {
+        slot.store(0, std::memory_order_relaxed);
+    }
+}
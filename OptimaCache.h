@@ -0,0 +1,42 @@
+#pragma once
+
+// Hashes (see TourModifier::hash) of local optima already explored by a search, so that trials reaching one
+// again can be abandoned. A fixed-size direct-mapped table: a new hash overwrites whatever shared its slot,
+// so memory stays bounded and a forgotten optimum only costs a redundant climb.
+// Safe to use from several threads at once.
+
+#include <atomic>
+#include <cstddef> // size_t
+#include <cstdint>
+#include <vector>
+
+class OptimaCache
+{
+public:
+    // capacity is rounded up to a power of two; 0 disables the cache.
+    OptimaCache(size_t capacity = 0);
+
+    void clear();
+
+    bool contains(uint64_t hash) const
+    {
+        return not m_slots.empty() and m_slots[slot(hash)].load(std::memory_order_relaxed) == stored(hash);
+    }
+
+    void insert(uint64_t hash)
+    {
+        if (not m_slots.empty())
+        {
+            m_slots[slot(hash)].store(stored(hash), std::memory_order_relaxed);
+        }
+    }
+
+private:
+    std::vector<std::atomic<uint64_t>> m_slots;
+    int m_shift {64};
+
+    // the hash is already mixed, so its top bits select the slot.
+    size_t slot(uint64_t hash) const { return m_shift == 64 ? 0 : hash >> m_shift; }
+    // 0 marks an empty slot.
+    static uint64_t stored(uint64_t hash) { return hash == 0 ? 1 : hash; }
+};
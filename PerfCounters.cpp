@@ -0,0 +1,103 @@
+#include "PerfCounters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring> // memset
+#endif
+
+PerfCounters::PerfCounters()
+{
+#ifdef __linux__
+    constexpr std::array<uint64_t, EventCount> configs {PERF_COUNT_HW_CPU_CYCLES
+        , PERF_COUNT_HW_INSTRUCTIONS
+        , PERF_COUNT_HW_CACHE_MISSES // last level cache.
+        , PERF_COUNT_HW_BRANCH_MISSES};
+    for (int event {0}; event < EventCount; ++event)
+    {
+        perf_event_attr attributes;
+        std::memset(&attributes, 0, sizeof(attributes));
+        attributes.size = sizeof(attributes);
+        attributes.type = PERF_TYPE_HARDWARE;
+        attributes.config = configs[event];
+        attributes.read_format = PERF_FORMAT_GROUP;
+        attributes.disabled = m_leader < 0 ? 1 : 0; // the group starts with its leader.
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        const int fd = syscall(SYS_perf_event_open, &attributes, 0, -1, m_leader, 0);
+        if (fd < 0)
+        {
+            continue;
+        }
+        if (m_leader < 0)
+        {
+            m_leader = fd;
+        }
+        m_fds[event] = fd;
+        m_slots[event] = m_opened++;
+    }
+    if (m_leader >= 0)
+    {
+        ioctl(m_leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(m_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+}
+
+PerfCounters::~PerfCounters()
+{
+#ifdef __linux__
+    for (auto fd : m_fds)
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+    }
+#endif
+}
+
+PerfCounters::Sample PerfCounters::read() const
+{
+    Sample sample {};
+#ifdef __linux__
+    if (m_leader < 0)
+    {
+        return sample;
+    }
+    // group read format: value count, then the values in opening order.
+    std::array<uint64_t, EventCount + 1> values {};
+    if (::read(m_leader, values.data(), sizeof(values)) < static_cast<ssize_t>((m_opened + 1) * sizeof(uint64_t)))
+    {
+        return sample;
+    }
+    for (int event {0}; event < EventCount; ++event)
+    {
+        if (m_slots[event] >= 0)
+        {
+            sample[event] = values[m_slots[event] + 1];
+        }
+    }
+#endif
+    return sample;
+}
+
+const char* PerfCounters::name(Event event)
+{
+    switch (event)
+    {
+        case Cycles:
+            return "cycles";
+        case Instructions:
+            return "instructions";
+        case CacheMisses:
+            return "LLC misses";
+        case BranchMisses:
+            return "branch misses";
+        default:
+            return "";
+    }
+}
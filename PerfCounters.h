@@ -0,0 +1,32 @@
+#pragma once
+
+// Hardware counters of the calling thread (Linux perf_event_open), for profiling phases of a search (see profile.h).
+// Counters the kernel does not permit (perf_event_paranoid, containers) or the hardware lacks read as 0;
+// on other systems none are available.
+
+#include <array>
+#include <cstdint>
+
+class PerfCounters
+{
+public:
+    enum Event { Cycles, Instructions, CacheMisses, BranchMisses, EventCount };
+    using Sample = std::array<uint64_t, EventCount>;
+
+    // Opens the counters for the calling thread, which alone may read them.
+    PerfCounters();
+    ~PerfCounters();
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool available(Event event) const { return m_slots[event] >= 0; }
+    Sample read() const;
+
+    static const char* name(Event event);
+
+private:
+    int m_leader {-1}; // file descriptor of the group, read at once.
+    std::array<int, EventCount> m_fds {-1, -1, -1, -1};
+    std::array<int, EventCount> m_slots {-1, -1, -1, -1}; // position in the group read, -1 if not opened.
+    int m_opened {0};
+};
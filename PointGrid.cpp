@@ -0,0 +1,102 @@
+#include "PointGrid.h"
+
+PointGrid::PointGrid(const std::vector<primitives::space_t>& x
+    , const std::vector<primitives::space_t>& y
+    , primitives::point_id_t points_per_cell)
+    : m_x(x)
+    , m_y(y)
+{
+    if (x.empty())
+    {
+        m_cell_start.assign(2, 0);
+        return;
+    }
+    m_min_x = *std::min_element(x.cbegin(), x.cend());
+    m_min_y = *std::min_element(y.cbegin(), y.cend());
+    const auto width {*std::max_element(x.cbegin(), x.cend()) - m_min_x};
+    const auto height {*std::max_element(y.cbegin(), y.cend()) - m_min_y};
+    const auto cell_count {std::max<primitives::space_t>(1, x.size() / std::max<primitives::point_id_t>(points_per_cell, 1))};
+    m_cell_size = std::sqrt(width * height / cell_count);
+    // elongated or degenerate point sets would otherwise get far more cells than points.
+    m_cell_size = std::max(m_cell_size, std::max(width, height) / cell_count);
+    if (not (m_cell_size > 0))
+    {
+        m_cell_size = 1; // all points coincide.
+    }
+    m_columns = static_cast<int>(width / m_cell_size) + 1;
+    m_rows = static_cast<int>(height / m_cell_size) + 1;
+
+    // counting sort of points by cell.
+    m_cell_start.assign(m_columns * m_rows + 1, 0);
+    for (primitives::point_id_t i {0}; i < x.size(); ++i)
+    {
+        ++m_cell_start[cell(column(i), row(i)) + 1];
+    }
+    for (size_t c {1}; c < m_cell_start.size(); ++c)
+    {
+        m_cell_start[c] += m_cell_start[c - 1];
+    }
+    m_points.resize(x.size());
+    auto fill {m_cell_start};
+    for (primitives::point_id_t i {0}; i < x.size(); ++i)
+    {
+        m_points[fill[cell(column(i), row(i))]++] = i;
+    }
+}
+
+void PointGrid::nearest(primitives::point_id_t i, primitives::point_id_t k, std::vector<primitives::point_id_t>& neighbors) const
+{
+    neighbors.clear();
+    const int c {column(i)};
+    const int r {row(i)};
+    const int max_ring {std::max(m_columns, m_rows)};
+    for (int ring {0}; ring <= max_ring and k > 0; ++ring)
+    {
+        for (int row {r - ring}; row <= r + ring; ++row)
+        {
+            if (row < 0 or row >= m_rows)
+            {
+                continue;
+            }
+            const bool edge_row {row == r - ring or row == r + ring};
+            const int step {edge_row ? 1 : 2 * ring};
+            for (int column {c - ring}; column <= c + ring; column += step)
+            {
+                if (column < 0 or column >= m_columns)
+                {
+                    continue;
+                }
+                const auto current_cell {cell(column, row)};
+                for (auto p {m_cell_start[current_cell]}; p < m_cell_start[current_cell + 1]; ++p)
+                {
+                    const auto j {m_points[p]};
+                    if (j == i)
+                    {
+                        continue;
+                    }
+                    // insertion into the sorted neighbors, dropping the farthest beyond k.
+                    const auto distance {squared_distance(i, j)};
+                    if (neighbors.size() == k and distance >= squared_distance(i, neighbors.back()))
+                    {
+                        continue;
+                    }
+                    if (neighbors.size() == k)
+                    {
+                        neighbors.pop_back();
+                    }
+                    auto position {neighbors.end()};
+                    while (position != neighbors.begin() and squared_distance(i, *(position - 1)) > distance)
+                    {
+                        --position;
+                    }
+                    neighbors.insert(position, j);
+                }
+            }
+        }
+        const auto ring_distance {ring * m_cell_size};
+        if (neighbors.size() == k and squared_distance(i, neighbors.back()) <= ring_distance * ring_distance)
+        {
+            break;
+        }
+    }
+}
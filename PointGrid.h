@@ -0,0 +1,141 @@
+#pragma once
+
+// Uniform grid over a point set for nearest-neighbor queries.
+// Holds references to the coordinates, which must outlive the grid.
+
+#include "constants.h"
+#include "primitives.h"
+
+#include <algorithm> // max, min
+#include <cmath> // sqrt
+#include <vector>
+
+class PointGrid
+{
+public:
+    PointGrid(const std::vector<primitives::space_t>& x
+        , const std::vector<primitives::space_t>& y
+        , primitives::point_id_t points_per_cell = 2);
+
+    // Returns the nearest point j != i for which accept(j) is true, or constants::invalid_point.
+    template <typename Accept>
+    primitives::point_id_t nearest(primitives::point_id_t i, const Accept& accept) const;
+
+    // Calls visit(j) for the points j != i within radius of i, in no particular order, until it returns true.
+    // Returns true if visit did.
+    template <typename Visit>
+    bool within(primitives::point_id_t i, primitives::space_t radius, const Visit& visit) const;
+
+    // Replaces neighbors with the (up to) k nearest points other than i, nearest first.
+    void nearest(primitives::point_id_t i, primitives::point_id_t k, std::vector<primitives::point_id_t>& neighbors) const;
+
+    // Area covered by the cells.
+    primitives::space_t area() const { return m_columns * m_rows * m_cell_size * m_cell_size; }
+
+    primitives::space_t squared_distance(primitives::point_id_t a, primitives::point_id_t b) const
+    {
+        const auto dx {m_x[a] - m_x[b]};
+        const auto dy {m_y[a] - m_y[b]};
+        return dx * dx + dy * dy;
+    }
+
+private:
+    const std::vector<primitives::space_t>& m_x;
+    const std::vector<primitives::space_t>& m_y;
+    primitives::space_t m_min_x {0};
+    primitives::space_t m_min_y {0};
+    primitives::space_t m_cell_size {1};
+    int m_columns {1};
+    int m_rows {1};
+    // points of cell c are m_points[m_cell_start[c]] to m_points[m_cell_start[c + 1] - 1].
+    std::vector<primitives::point_id_t> m_cell_start;
+    std::vector<primitives::point_id_t> m_points;
+
+    int column(primitives::point_id_t i) const
+    {
+        return std::min(m_columns - 1, static_cast<int>((m_x[i] - m_min_x) / m_cell_size));
+    }
+    int row(primitives::point_id_t i) const
+    {
+        return std::min(m_rows - 1, static_cast<int>((m_y[i] - m_min_y) / m_cell_size));
+    }
+    int cell(int column, int row) const { return row * m_columns + column; }
+};
+
+template <typename Accept>
+primitives::point_id_t PointGrid::nearest(primitives::point_id_t i, const Accept& accept) const
+{
+    const int c {column(i)};
+    const int r {row(i)};
+    primitives::point_id_t best {constants::invalid_point};
+    primitives::space_t best_distance {0};
+    const int max_ring {std::max(m_columns, m_rows)};
+    for (int ring {0}; ring <= max_ring; ++ring)
+    {
+        for (int row {r - ring}; row <= r + ring; ++row)
+        {
+            if (row < 0 or row >= m_rows)
+            {
+                continue;
+            }
+            // inner rows of the ring only have cells on the left and right edges.
+            const bool edge_row {row == r - ring or row == r + ring};
+            const int step {edge_row ? 1 : 2 * ring};
+            for (int column {c - ring}; column <= c + ring; column += step)
+            {
+                if (column < 0 or column >= m_columns)
+                {
+                    continue;
+                }
+                const auto current_cell {cell(column, row)};
+                for (auto k {m_cell_start[current_cell]}; k < m_cell_start[current_cell + 1]; ++k)
+                {
+                    const auto j {m_points[k]};
+                    if (j == i or not accept(j))
+                    {
+                        continue;
+                    }
+                    const auto distance {squared_distance(i, j)};
+                    if (best == constants::invalid_point or distance < best_distance)
+                    {
+                        best = j;
+                        best_distance = distance;
+                    }
+                }
+            }
+        }
+        // points in further rings are at least ring * m_cell_size away.
+        const auto ring_distance {ring * m_cell_size};
+        if (best != constants::invalid_point and best_distance <= ring_distance * ring_distance)
+        {
+            break;
+        }
+    }
+    return best;
+}
+
+template <typename Visit>
+bool PointGrid::within(primitives::point_id_t i, primitives::space_t radius, const Visit& visit) const
+{
+    const int c {column(i)};
+    const int r {row(i)};
+    // cells beyond the radius (in cell units) from the cell of i are out of reach.
+    const int reach {static_cast<int>(std::min<primitives::space_t>(radius / m_cell_size + 1, std::max(m_columns, m_rows)))};
+    const auto squared_radius {radius * radius};
+    for (int row {std::max(0, r - reach)}; row <= std::min(m_rows - 1, r + reach); ++row)
+    {
+        for (int column {std::max(0, c - reach)}; column <= std::min(m_columns - 1, c + reach); ++column)
+        {
+            const auto current_cell {cell(column, row)};
+            for (auto k {m_cell_start[current_cell]}; k < m_cell_start[current_cell + 1]; ++k)
+            {
+                const auto j {m_points[k]};
+                if (j != i and squared_distance(i, j) <= squared_radius and visit(j))
+                {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
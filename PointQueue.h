@@ -0,0 +1,58 @@
+#pragma once
+
+// First-in, first-out queue of points whose neighborhood needs to be re-searched.
+// A point is never queued more than once at a time, so a ring buffer of the point count never overflows
+// and the queue does not allocate after construction.
+
+#include "primitives.h"
+
+#include <vector>
+
+class PointQueue
+{
+public:
+    PointQueue(primitives::point_id_t point_count = 0) { reset(point_count); }
+
+    // Empties the queue and sizes it for point_count points; allocates only when the size changes.
+    void reset(primitives::point_id_t point_count)
+    {
+        if (m_queued.size() != point_count)
+        {
+            m_ring.resize(point_count);
+            m_queued.assign(point_count, false);
+            m_head = 0;
+            m_size = 0;
+        }
+        while (not empty())
+        {
+            pop();
+        }
+    }
+
+    void push(primitives::point_id_t i)
+    {
+        if (not m_queued[i])
+        {
+            m_queued[i] = true;
+            m_ring[(m_head + m_size) % m_ring.size()] = i;
+            ++m_size;
+        }
+    }
+
+    primitives::point_id_t pop()
+    {
+        const auto i {m_ring[m_head]};
+        m_head = (m_head + 1) % m_ring.size();
+        --m_size;
+        m_queued[i] = false;
+        return i;
+    }
+
+    bool empty() const { return m_size == 0; }
+
+private:
+    std::vector<primitives::point_id_t> m_ring;
+    std::vector<bool> m_queued;
+    primitives::point_id_t m_head {0};
+    primitives::point_id_t m_size {0};
+};
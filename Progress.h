@@ -0,0 +1,22 @@
+#pragma once
+
+#include "primitives.h"
+
+struct Progress
+{
+    enum class Event
+    {
+        Initial, // length of the initial tour.
+        Climbed, // length after the initial multi-climb.
+        LowerBound, // length is the Held-Karp lower bound on the optimal length.
+        Backbone, // cost is the number of edges fixed for the perturbation phase.
+        PerturbationCost, // a perturbation phase started a new cost level.
+        Improvement, // a perturbation phase improved the best tour.
+        Finished // length of the final tour.
+    };
+    Event event {Event::Initial};
+    const char* phase {""}; // operator name for perturbation events.
+    primitives::length_t length {0}; // best tour length so far.
+    primitives::length_t cost {0}; // perturbation cost level (or fixed edge count).
+    double seconds {0}; // time since the solve started.
+};
@@ -0,0 +1,44 @@
+#include "ProgressReporter.h"
+
+ProgressReporter::ProgressReporter(Callback callback)
+    : m_callback(std::move(callback))
+    , m_thread(&ProgressReporter::run, this)
+{
+}
+
+ProgressReporter::~ProgressReporter()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_done = true;
+    }
+    m_condition.notify_one();
+    m_thread.join();
+}
+
+void ProgressReporter::post(const Progress& progress)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(progress);
+    }
+    m_condition.notify_one();
+}
+
+void ProgressReporter::run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_condition.wait(lock, [this] { return m_done or not m_queue.empty(); });
+        if (m_queue.empty())
+        {
+            return; // done.
+        }
+        const auto progress {m_queue.front()};
+        m_queue.pop_front();
+        lock.unlock();
+        m_callback(progress);
+        lock.lock();
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+// Delivers progress to a callback on a separate thread,
+// so that posting never waits on the callback.
+
+#include "Progress.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+class ProgressReporter
+{
+public:
+    using Callback = std::function<void(const Progress&)>;
+
+    ProgressReporter(Callback callback);
+    ~ProgressReporter(); // delivers all posted progress before returning.
+
+    ProgressReporter(const ProgressReporter&) = delete;
+    ProgressReporter& operator=(const ProgressReporter&) = delete;
+
+    void post(const Progress& progress);
+
+private:
+    Callback m_callback;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<Progress> m_queue;
+    bool m_done {false};
+    std::thread m_thread; // last, so that it starts after the other members.
+
+    void run();
+};
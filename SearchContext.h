@@ -0,0 +1,161 @@
+#pragma once
+
+// Settings and reporting shared by the phases of one search.
+// A default-constructed context uses all operators, one thread, no time limit or target,
+// keeps no visited optima, searches all lateral moves, and reports nothing.
+
+#include "NeighborLists.h"
+#include "Operators.h"
+#include "OptimaCache.h"
+#include "Progress.h"
+#include "ProgressReporter.h"
+#include "TourModifier.h"
+#include "primitives.h"
+
+#include <algorithm> // max, min
+#include <chrono>
+#include <cstddef> // size_t
+#include <functional>
+#include <limits>
+#include <vector>
+
+class SearchContext
+{
+    using clock = std::chrono::steady_clock;
+public:
+    // Receives a snapshot of the tour whenever the search improves it; called on the search thread.
+    using TourCallback = std::function<void(std::vector<primitives::point_id_t> ordered_points, primitives::length_t length)>;
+
+    SearchContext() = default;
+    SearchContext(const Operators& operators
+        , unsigned threads
+        , double time_budget
+        , primitives::point_id_t tabu_tenure
+        , ProgressReporter* reporter
+        , const TourCallback* tour_callback = nullptr)
+        : m_operators(operators)
+        , m_threads(threads)
+        , m_tabu_tenure(tabu_tenure)
+        , m_reporter(reporter)
+        , m_tour_callback(tour_callback)
+    {
+        if (time_budget > 0)
+        {
+            m_deadline = m_start + std::chrono::duration_cast<clock::duration>(
+                std::chrono::duration<double>(time_budget));
+        }
+    }
+
+    const Operators& operators() const { return m_operators; }
+    unsigned threads() const { return m_threads; }
+    primitives::point_id_t tabu_tenure() const { return m_tabu_tenure; }
+
+    bool expired() const { return m_deadline != clock::time_point::max() and clock::now() > m_deadline; }
+
+    // Seconds left before the time budget runs out; infinite without a budget.
+    double remaining() const
+    {
+        if (m_deadline == clock::time_point::max())
+        {
+            return std::numeric_limits<double>::infinity();
+        }
+        return std::max(0.0, std::chrono::duration<double>(m_deadline - clock::now()).count());
+    }
+
+    // A copy whose time budget ends at most seconds from now.
+    SearchContext limited(double seconds) const
+    {
+        auto copy {*this};
+        const auto deadline {clock::now() + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(seconds))};
+        copy.m_deadline = std::min(m_deadline, deadline);
+        return copy;
+    }
+
+    // A copy for searching another instance (e.g. a coarse level, see multilevel.h):
+    // it reports nothing, takes no snapshots, searches all lateral moves, and has no target
+    // or visited optima (both are of the original instance).
+    SearchContext silent() const
+    {
+        auto copy {*this};
+        copy.m_reporter = nullptr;
+        copy.m_tour_callback = nullptr;
+        copy.m_neighbors = nullptr;
+        copy.m_repair_neighbors = nullptr;
+        copy.m_lower_bound = 0;
+        copy.m_optima = nullptr;
+        return copy;
+    }
+
+    // The search stops once a tour is within target_gap (relative) of lower_bound.
+    void set_target(primitives::length_t lower_bound, double target_gap)
+    {
+        m_lower_bound = lower_bound;
+        m_target_gap = target_gap;
+    }
+    bool target_reached(primitives::length_t length) const
+    {
+        return m_lower_bound > 0
+            and (length <= m_lower_bound or length - m_lower_bound <= m_target_gap * m_lower_bound);
+    }
+
+    // Non-improving trials of a cost level are perturbed again, keeping the width shortest per level,
+    // down to depth perturbations; a width of 0 (the default) or a depth below 2 disables the beam.
+    void set_beam(size_t width, unsigned depth)
+    {
+        m_beam_width = width;
+        m_beam_depth = depth;
+    }
+    size_t beam_width() const { return m_beam_width; }
+    unsigned beam_depth() const { return m_beam_depth; }
+    bool beam() const { return m_beam_width > 0 and m_beam_depth > 1; }
+
+    // If set, lateral moves only add segments between points and their neighbors (see find_moves in OperatorSet.h).
+    // The lists must be of the instance of the searched tours.
+    void set_neighbors(const NeighborLists* neighbors) { m_neighbors = neighbors; }
+    const NeighborLists* neighbors() const { return m_neighbors; }
+    // Likewise for the repairs and climbs of perturbation trials (see point_improvement in OperatorSet.h),
+    // which then take O(k) per searched point instead of O(n).
+    void set_repair_neighbors(const NeighborLists* neighbors) { m_repair_neighbors = neighbors; }
+    const NeighborLists* repair_neighbors() const { return m_repair_neighbors; }
+
+    // Local optima explored by this search, if it keeps track of them.
+    void set_optima(OptimaCache* optima) { m_optima = optima; }
+    OptimaCache* optima() const { return m_optima; }
+
+    double seconds() const { return std::chrono::duration<double>(clock::now() - m_start).count(); }
+
+    void report(Progress::Event event
+        , primitives::length_t length
+        , const char* phase = ""
+        , primitives::length_t cost = 0) const
+    {
+        if (m_reporter)
+        {
+            m_reporter->post({event, phase, length, cost, seconds()});
+        }
+    }
+
+    void snapshot(const TourModifier& tour) const
+    {
+        if (m_tour_callback and *m_tour_callback)
+        {
+            (*m_tour_callback)(tour.order(), tour.length());
+        }
+    }
+
+private:
+    Operators m_operators;
+    unsigned m_threads {1};
+    primitives::point_id_t m_tabu_tenure {0};
+    ProgressReporter* m_reporter {nullptr};
+    const TourCallback* m_tour_callback {nullptr};
+    clock::time_point m_start {clock::now()};
+    clock::time_point m_deadline {clock::time_point::max()};
+    primitives::length_t m_lower_bound {0};
+    double m_target_gap {0};
+    OptimaCache* m_optima {nullptr};
+    const NeighborLists* m_neighbors {nullptr};
+    const NeighborLists* m_repair_neighbors {nullptr};
+    size_t m_beam_width {0};
+    unsigned m_beam_depth {1};
+};
@@ -0,0 +1,87 @@
+#include "SegmentGrid.h"
+
+#include <algorithm> // find, max, min, min_element, max_element
+#include <cmath> // sqrt
+
+SegmentGrid::SegmentGrid(const std::vector<primitives::space_t>& x
+    , const std::vector<primitives::space_t>& y
+    , primitives::point_id_t points_per_cell)
+    : m_x(x)
+    , m_y(y)
+{
+    if (not x.empty())
+    {
+        m_min_x = *std::min_element(x.cbegin(), x.cend());
+        m_min_y = *std::min_element(y.cbegin(), y.cend());
+        const auto width {*std::max_element(x.cbegin(), x.cend()) - m_min_x};
+        const auto height {*std::max_element(y.cbegin(), y.cend()) - m_min_y};
+        const auto cell_count {std::max<primitives::space_t>(1, x.size() / std::max<primitives::point_id_t>(points_per_cell, 1))};
+        m_cell_size = std::sqrt(width * height / cell_count);
+        m_cell_size = std::max(m_cell_size, std::max(width, height) / cell_count);
+        if (not (m_cell_size > 0))
+        {
+            m_cell_size = 1;
+        }
+        m_columns = static_cast<int>(width / m_cell_size) + 1;
+        m_rows = static_cast<int>(height / m_cell_size) + 1;
+    }
+    m_cells.resize(m_columns * m_rows);
+}
+
+int SegmentGrid::column(primitives::space_t x) const
+{
+    return std::max(0, std::min(m_columns - 1, static_cast<int>((x - m_min_x) / m_cell_size)));
+}
+
+int SegmentGrid::row(primitives::space_t y) const
+{
+    return std::max(0, std::min(m_rows - 1, static_cast<int>((y - m_min_y) / m_cell_size)));
+}
+
+void SegmentGrid::insert(primitives::point_id_t a, primitives::point_id_t b)
+{
+    const auto k {key(a, b)};
+    for_each_cell(a, b, [this, k](int cell)
+    {
+        m_cells[cell].push_back(k);
+        return false;
+    });
+}
+
+void SegmentGrid::erase(primitives::point_id_t a, primitives::point_id_t b)
+{
+    const auto k {key(a, b)};
+    for_each_cell(a, b, [this, k](int cell)
+    {
+        auto& segments {m_cells[cell]};
+        const auto it {std::find(segments.begin(), segments.end(), k)};
+        if (it != segments.end())
+        {
+            *it = segments.back();
+            segments.pop_back();
+        }
+        return false;
+    });
+}
+
+primitives::space_t SegmentGrid::orientation(primitives::point_id_t a, primitives::point_id_t b, primitives::point_id_t c) const
+{
+    return (m_x[b] - m_x[a]) * (m_y[c] - m_y[a]) - (m_y[b] - m_y[a]) * (m_x[c] - m_x[a]);
+}
+
+bool SegmentGrid::crosses(primitives::point_id_t a, primitives::point_id_t b, primitives::point_id_t c, primitives::point_id_t d) const
+{
+    if (a == c or a == d or b == c or b == d)
+    {
+        return false;
+    }
+    const auto c_side {orientation(a, b, c)};
+    const auto d_side {orientation(a, b, d)};
+    if (not ((c_side > 0 and d_side < 0) or (c_side < 0 and d_side > 0)))
+    {
+        return false;
+    }
+    const auto a_side {orientation(c, d, a)};
+    const auto b_side {orientation(c, d, b)};
+    return (a_side > 0 and b_side < 0) or (a_side < 0 and b_side > 0);
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+// Uniform grid over a set of segments between points, for finding segments that cross a given one.
+// Every cell a segment passes through lists it, so two crossing segments share at least the cell of their crossing.
+// Holds references to the coordinates, which must outlive the grid.
+
+#include "constants.h"
+#include "primitives.h"
+
+#include <algorithm> // max, min
+#include <cstdint>
+#include <utility> // pair, swap
+#include <vector>
+
+class SegmentGrid
+{
+public:
+    SegmentGrid(const std::vector<primitives::space_t>& x
+        , const std::vector<primitives::space_t>& y
+        , primitives::point_id_t points_per_cell = 2);
+
+    void insert(primitives::point_id_t a, primitives::point_id_t b);
+    void erase(primitives::point_id_t a, primitives::point_id_t b);
+
+    // Returns a segment (c, d) that properly crosses (a, b) and for which accept(c, d) is true,
+    // or a pair of invalid points if there is none.
+    // Segments sharing a point with (a, b) and collinear overlaps do not count.
+    template <typename Accept>
+    std::pair<primitives::point_id_t, primitives::point_id_t> find_crossing(primitives::point_id_t a
+        , primitives::point_id_t b
+        , const Accept& accept) const;
+
+    bool crosses(primitives::point_id_t a, primitives::point_id_t b, primitives::point_id_t c, primitives::point_id_t d) const;
+
+private:
+    const std::vector<primitives::space_t>& m_x;
+    const std::vector<primitives::space_t>& m_y;
+    primitives::space_t m_min_x {0};
+    primitives::space_t m_min_y {0};
+    primitives::space_t m_cell_size {1};
+    int m_columns {1};
+    int m_rows {1};
+    std::vector<std::vector<uint64_t>> m_cells; // segment keys.
+
+    static uint64_t key(primitives::point_id_t a, primitives::point_id_t b)
+    {
+        return a < b ? (static_cast<uint64_t>(a) << 32) | b : (static_cast<uint64_t>(b) << 32) | a;
+    }
+    int column(primitives::space_t x) const;
+    int row(primitives::space_t y) const;
+    primitives::space_t orientation(primitives::point_id_t a, primitives::point_id_t b, primitives::point_id_t c) const;
+
+    // Calls visit(cell index) for every cell (a, b) passes through, until it returns true; returns true if it did.
+    template <typename Visit>
+    bool for_each_cell(primitives::point_id_t a, primitives::point_id_t b, const Visit& visit) const;
+};
+
+template <typename Visit>
+bool SegmentGrid::for_each_cell(primitives::point_id_t a, primitives::point_id_t b, const Visit& visit) const
+{
+    if (m_x[b] < m_x[a])
+    {
+        std::swap(a, b);
+    }
+    const auto dx {m_x[b] - m_x[a]};
+    const auto dy {m_y[b] - m_y[a]};
+    // a margin keeps crossings on cell borders from falling between the cells of the two segments.
+    const auto margin {m_cell_size * 1e-9};
+    const int first_column {column(m_x[a] - margin)};
+    const int last_column {column(m_x[b] + margin)};
+    for (int c {first_column}; c <= last_column; ++c)
+    {
+        // part of the segment within the column.
+        auto y0 {m_y[a]};
+        auto y1 {m_y[b]};
+        if (dx > 0)
+        {
+            const auto left {std::max(m_x[a], m_min_x + c * m_cell_size - margin)};
+            const auto right {std::min(m_x[b], m_min_x + (c + 1) * m_cell_size + margin)};
+            y0 = m_y[a] + dy * (left - m_x[a]) / dx;
+            y1 = m_y[a] + dy * (right - m_x[a]) / dx;
+        }
+        if (y1 < y0)
+        {
+            std::swap(y0, y1);
+        }
+        const int last_row {row(y1 + margin)};
+        for (int r {row(y0 - margin)}; r <= last_row; ++r)
+        {
+            if (visit(r * m_columns + c))
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+template <typename Accept>
+std::pair<primitives::point_id_t, primitives::point_id_t> SegmentGrid::find_crossing(primitives::point_id_t a
+    , primitives::point_id_t b
+    , const Accept& accept) const
+{
+    std::pair<primitives::point_id_t, primitives::point_id_t> crossing {constants::invalid_point, constants::invalid_point};
+    for_each_cell(a, b, [&](int cell)
+    {
+        for (auto k : m_cells[cell])
+        {
+            const primitives::point_id_t c = k >> 32;
+            const primitives::point_id_t d = k & 0xFFFFFFFF;
+            if (crosses(a, b, c, d) and accept(c, d))
+            {
+                crossing = {c, d};
+                return true;
+            }
+        }
+        return false;
+    });
+    return crossing;
+}
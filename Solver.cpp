@@ -0,0 +1,148 @@
+#include "Solver.h"
+
+#include "backbone.h"
+#include "lower_bound.h"
+#include "multilevel.h"
+#include "perturbation.h"
+#include "solver.h"
+#include "twoopt/uncross.h"
+
+#include <memory> // unique_ptr
+
+Solver::Solver(const std::vector<primitives::space_t>& x
+    , const std::vector<primitives::space_t>& y
+    , const SolverOptions& options)
+    : m_x(x)
+    , m_y(y)
+    , m_options(options)
+    , m_optima(options.visited_optima)
+{
+}
+
+void Solver::set_points(const std::vector<primitives::space_t>& x, const std::vector<primitives::space_t>& y)
+{
+    m_x = x;
+    m_y = y;
+    m_matrix.reset();
+}
+
+const std::vector<primitives::point_id_t>& Solver::solve()
+{
+    return run(nullptr);
+}
+
+const std::vector<primitives::point_id_t>& Solver::solve(const std::vector<primitives::point_id_t>& initial_tour)
+{
+    return run(&initial_tour);
+}
+
+const std::vector<primitives::point_id_t>& Solver::run(const std::vector<primitives::point_id_t>* initial_tour)
+{
+    std::unique_ptr<ProgressReporter> reporter;
+    if (m_callback)
+    {
+        reporter = std::make_unique<ProgressReporter>(m_callback);
+    }
+    SearchContext context(m_options.operators
+        , m_options.threads
+        , m_options.time_budget
+        , m_options.tabu_tenure
+        , reporter.get()
+        , &m_tour_callback);
+    m_optima.clear();
+    context.set_optima(&m_optima);
+    context.set_beam(m_options.beam_width, m_options.beam_depth);
+    const auto& operators {context.operators()};
+    const auto instance {std::make_shared<const Instance>(m_x, m_y, m_matrix)};
+    if (not initial_tour)
+    {
+        if (m_options.multilevel and not m_matrix)
+        {
+            m_initial_tour = multilevel::solve(instance, m_options.coarsest_size, m_options.perturbation, context);
+        }
+        else
+        {
+            m_initial_tour.clear();
+            for (primitives::point_id_t i {0}; i < m_x.size(); ++i)
+            {
+                m_initial_tour.push_back(i);
+            }
+        }
+        initial_tour = &m_initial_tour;
+    }
+
+    if (m_tour_modifier)
+    {
+        m_tour_modifier->reset(*initial_tour, instance);
+    }
+    else
+    {
+        m_tour_modifier.emplace(*initial_tour, instance);
+    }
+    auto& tour {*m_tour_modifier};
+    context.report(Progress::Event::Initial, tour.length());
+    // the journal starts after uncrossing, which rebuilds the tour.
+    tour.set_journal(nullptr);
+    const bool uncross {operators.two_opt and tour.size() >= m_options.uncross_min_points};
+    if (uncross)
+    {
+        twoopt::uncross::remove_crossings(tour);
+    }
+    m_journal.start(m_options.journal ? tour.order() : std::vector<primitives::point_id_t>{});
+    tour.set_journal(m_options.journal ? &m_journal : nullptr);
+    solver::multi_climb(tour, operators, m_options.batch_moves);
+    context.report(Progress::Event::Climbed, tour.length());
+    context.snapshot(tour);
+
+    m_lower_bound = 0;
+    if (m_options.target_gap > 0)
+    {
+        m_lower_bound = lower_bound::held_karp(*instance, tour.order(), tour.length());
+        if (m_lower_bound > 0)
+        {
+            context.report(Progress::Event::LowerBound, m_lower_bound);
+            context.set_target(m_lower_bound, m_options.target_gap);
+        }
+    }
+    if (m_options.perturbation)
+    {
+        if (m_options.lateral_neighbors > 0)
+        {
+            m_neighbors.build(*instance, m_options.lateral_neighbors);
+            context.set_neighbors(&m_neighbors);
+        }
+        // explicit instances would need a sort of every matrix row.
+        if (m_options.repair_neighbors > 0 and instance->grid())
+        {
+            m_repair_neighbors.build(*instance, m_options.repair_neighbors);
+            context.set_repair_neighbors(&m_repair_neighbors);
+        }
+        if (m_options.backbone_climbs > 0)
+        {
+            tour.set_fixed(backbone::find(tour, m_options.backbone_climbs, context, uncross));
+            if (tour.fixed())
+            {
+                context.report(Progress::Event::Backbone, tour.length(), "", tour.fixed()->size());
+            }
+        }
+        perturbation::climb(tour, context);
+        if (tour.fixed())
+        {
+            tour.set_fixed(nullptr);
+            // settles the moves that the fixed edges ruled out, unless out of time.
+            if (not context.expired())
+            {
+                const auto fixed_length {tour.length()};
+                solver::multi_climb(tour, operators);
+                if (tour.length() < fixed_length)
+                {
+                    context.snapshot(tour);
+                }
+            }
+        }
+    }
+    m_tour = tour.order();
+    m_length = tour.length();
+    context.report(Progress::Event::Finished, m_length);
+    return m_tour;
+}
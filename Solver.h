@@ -0,0 +1,77 @@
+#pragma once
+
+// Runs the full search (multi-climb followed by perturbation climbs) on an in-memory point set.
+
+#include "DistanceMatrix.h"
+#include "MoveJournal.h"
+#include "NeighborLists.h"
+#include "OptimaCache.h"
+#include "Progress.h"
+#include "ProgressReporter.h"
+#include "SearchContext.h"
+#include "SolverOptions.h"
+#include "TourModifier.h"
+#include "primitives.h"
+
+#include <memory> // shared_ptr
+#include <optional>
+#include <vector>
+
+class Solver
+{
+public:
+    Solver(const SolverOptions& options = {}) : m_options(options), m_optima(options.visited_optima) {}
+    Solver(const std::vector<primitives::space_t>& x
+        , const std::vector<primitives::space_t>& y
+        , const SolverOptions& options = {});
+
+    // Replaces the point set and drops any matrix; storage from previous solves is reused.
+    void set_points(const std::vector<primitives::space_t>& x, const std::vector<primitives::space_t>& y);
+
+    // Takes lengths from matrix instead of coordinates, e.g. for explicit instances.
+    // Multi-level solving needs coordinates, so it is skipped while a matrix is set.
+    void set_matrix(std::shared_ptr<const DistanceMatrix> matrix) { m_matrix = std::move(matrix); }
+
+    // Called on a separate thread; the search does not wait for it to return.
+    void set_progress_callback(ProgressReporter::Callback callback) { m_callback = std::move(callback); }
+
+    // Called on the search thread with a copy of the tour after the initial climb and after every improvement;
+    // it should hand the tour off (e.g. to a TourWriter) rather than do slow work itself.
+    void set_tour_callback(SearchContext::TourCallback callback) { m_tour_callback = std::move(callback); }
+
+    // Returns the final tour. Without an initial tour, points are visited in index order,
+    // or the multi-level solution is used if enabled in the options.
+    const std::vector<primitives::point_id_t>& solve();
+    const std::vector<primitives::point_id_t>& solve(const std::vector<primitives::point_id_t>& initial_tour);
+
+    const std::vector<primitives::point_id_t>& tour() const { return m_tour; }
+    primitives::length_t length() const { return m_length; }
+
+    // Held-Karp lower bound of the last solve if a target gap is set in the options
+    // and the instance is small enough (see lower_bound::max_points), otherwise 0.
+    primitives::length_t lower_bound() const { return m_lower_bound; }
+
+    // Initial tour (after uncrossing, see SolverOptions::uncross_min_points) and moves of the last solve,
+    // if journaling is enabled in the options.
+    const MoveJournal& journal() const { return m_journal; }
+
+private:
+    std::vector<primitives::space_t> m_x;
+    std::vector<primitives::space_t> m_y;
+    std::shared_ptr<const DistanceMatrix> m_matrix;
+    const SolverOptions m_options;
+    ProgressReporter::Callback m_callback;
+    SearchContext::TourCallback m_tour_callback;
+
+    std::optional<TourModifier> m_tour_modifier; // kept between solves to reuse its storage.
+    std::vector<primitives::point_id_t> m_initial_tour;
+    MoveJournal m_journal;
+    OptimaCache m_optima; // of the current solve.
+    NeighborLists m_neighbors; // of the current instance, if lateral moves are restricted to them.
+    NeighborLists m_repair_neighbors; // likewise for trial repairs.
+    std::vector<primitives::point_id_t> m_tour;
+    primitives::length_t m_length {0};
+    primitives::length_t m_lower_bound {0};
+
+    const std::vector<primitives::point_id_t>& run(const std::vector<primitives::point_id_t>* initial_tour);
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Operators.h"
+#include "primitives.h"
+
+#include <cstddef> // size_t
+
+struct SolverOptions
+{
+    Operators operators; // used in both climbs and perturbations.
+    bool perturbation {true}; // run the lateral phase after the initial climb.
+    double time_budget {0}; // seconds; 0 means unlimited. Checked between perturbation trials.
+    unsigned threads {1}; // for perturbation trials of the same cost level.
+    // moves of a perturbation trial for which an edge it removed may not be added back.
+    primitives::point_id_t tabu_tenure {0};
+    // remove crossing segments before the initial climb of coordinate instances with at least this many points.
+    // Smaller instances climb to shorter tours from the tangled tour, larger ones climb much faster from the untangled one.
+    primitives::point_id_t uncross_min_points {2000};
+    bool batch_moves {false}; // the initial climb applies independent improving moves in batches (see solver::batch_climb).
+    bool multilevel {false}; // build the initial tour by coarsening (only when no initial tour is given).
+    primitives::point_id_t coarsest_size {1000}; // point count at which coarsening stops.
+    // lateral moves only add segments between points and their this many nearest neighbors; 0 searches all moves.
+    primitives::point_id_t lateral_neighbors {0};
+    // likewise for the repairs and climbs of perturbation trials on coordinate instances; 0 searches all moves.
+    primitives::point_id_t repair_neighbors {10};
+    // independent climbs whose common edges stay fixed during the perturbation phase (see backbone.h); 0 disables.
+    primitives::point_id_t backbone_climbs {0};
+    // stop perturbing once (length - lower bound) / lower bound is at most this; 0 disables (and skips the bound).
+    // Instances without a bound (see lower_bound::max_points) perturb as if it were 0.
+    double target_gap {0};
+    // local optima remembered so that perturbation trials reaching one again are abandoned; 0 disables.
+    size_t visited_optima {1 << 16};
+    // beam search over non-improving perturbation trials (see SearchContext::set_beam); width 0 disables it.
+    size_t beam_width {0};
+    unsigned beam_depth {2};
+    bool journal {false}; // record the moves applied to the tour (see Solver::journal).
+};
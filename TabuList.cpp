@@ -0,0 +1,68 @@
+#include "TabuList.h"
+
+#include <algorithm> // fill, max
+
+void TabuList::reset(primitives::point_id_t tenure, primitives::point_id_t edges_per_move)
+{
+    m_tenure = tenure;
+    m_now = 0;
+    // live entries: edges_per_move per move of the tenure, plus the pinned edges; kept under half the table.
+    const size_t live {static_cast<size_t>(edges_per_move) * (tenure + 2)};
+    size_t size {16};
+    int shift {60};
+    while (size < 2 * live)
+    {
+        size *= 2;
+        --shift;
+    }
+    if (size != m_table.size())
+    {
+        m_table.assign(size, {});
+        m_shift = shift;
+        m_generation = 1;
+        return;
+    }
+    if (++m_generation == 0)
+    {
+        std::fill(m_table.begin(), m_table.end(), Entry{});
+        m_generation = 1;
+    }
+}
+
+bool TabuList::contains(primitives::point_id_t a, primitives::point_id_t b) const
+{
+    const auto k {key(a, b)};
+    const auto mask {m_table.size() - 1};
+    const auto first {slot(k)};
+    for (size_t i {0}; i < probe_window; ++i)
+    {
+        const auto& entry {m_table[(first + i) & mask]};
+        if (entry.key == k and live(entry))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void TabuList::insert(uint64_t key, uint32_t expiry)
+{
+    const auto mask {m_table.size() - 1};
+    const auto first {slot(key)};
+    Entry* target {nullptr};
+    for (size_t i {0}; i < probe_window; ++i)
+    {
+        auto& entry {m_table[(first + i) & mask]};
+        if (entry.key == key and live(entry))
+        {
+            entry.expiry = std::max(entry.expiry, expiry);
+            return;
+        }
+        // prefer a free entry, otherwise the one expiring first.
+        if (not target or (live(*target) and (not live(entry) or entry.expiry < target->expiry)))
+        {
+            target = &entry;
+        }
+    }
+    *target = {key, expiry, m_generation};
+}
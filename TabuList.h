@@ -0,0 +1,54 @@
+#pragma once
+
+// Edges recently removed from a tour, each tabu (not to be added back) for a tenure of moves.
+// A fixed-size open-addressing table: expired entries are reused in place, and when a probe window
+// has no free entry the one expiring first is replaced, so memory stays bounded however long a search runs.
+
+#include "primitives.h"
+
+#include <cstddef> // size_t
+#include <cstdint>
+#include <vector>
+
+class TabuList
+{
+public:
+    // Empties the list, sized for tenure moves that each remove up to edges_per_move edges.
+    // Allocates only when the size changes.
+    void reset(primitives::point_id_t tenure, primitives::point_id_t edges_per_move);
+
+    // (a, b) stays tabu for the next tenure moves.
+    void add(primitives::point_id_t a, primitives::point_id_t b) { insert(key(a, b), m_now + m_tenure + 1); }
+    // (a, b) stays tabu until the next reset.
+    void pin(primitives::point_id_t a, primitives::point_id_t b) { insert(key(a, b), pinned); }
+
+    bool contains(primitives::point_id_t a, primitives::point_id_t b) const;
+
+    // Advances by one move.
+    void step() { ++m_now; }
+
+private:
+    struct Entry
+    {
+        uint64_t key {0};
+        uint32_t expiry {0}; // tabu while the move count is below this.
+        uint32_t generation {0}; // entries of earlier generations are free.
+    };
+    static constexpr uint32_t pinned {UINT32_MAX};
+    static constexpr size_t probe_window {8};
+
+    std::vector<Entry> m_table;
+    int m_shift {60};
+    uint32_t m_generation {1};
+    uint32_t m_now {0};
+    primitives::point_id_t m_tenure {0};
+
+    static uint64_t key(primitives::point_id_t a, primitives::point_id_t b)
+    {
+        return a < b ? (static_cast<uint64_t>(a) << 32) | b : (static_cast<uint64_t>(b) << 32) | a;
+    }
+    // first slot of the probe window of key (Fibonacci hashing).
+    size_t slot(uint64_t key) const { return (key * 0x9E3779B97F4A7C15ull) >> m_shift; }
+    bool live(const Entry& entry) const { return entry.generation == m_generation and entry.expiry > m_now; }
+    void insert(uint64_t key, uint32_t expiry);
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+// Climb rules (see solver::Unrestricted) for perturbation trials: a move may not add back an edge
+// of the tabu list, unless it makes the tour shorter than the aspiration length (a new best tour).
+// Every applied move adds the edges it removes to the tabu list.
+
+#include "TabuList.h"
+#include "TourModifier.h"
+#include "primitives.h"
+
+class TabuRules
+{
+public:
+    TabuRules(TabuList& tabu, primitives::length_t aspiration_length)
+        : m_tabu(tabu)
+        , m_aspiration_length(aspiration_length) {}
+
+    template <typename Operator>
+    bool allows(const TourModifier& tour, const typename Operator::Move& move) const
+    {
+        if (tour.length() - move.improvement < m_aspiration_length)
+        {
+            return true;
+        }
+        bool tabu {false};
+        Operator::for_each_added_edge(tour, move, [this, &tabu](primitives::point_id_t a, primitives::point_id_t b)
+        {
+            tabu = tabu or m_tabu.contains(a, b);
+        });
+        return not tabu;
+    }
+
+    template <typename Operator>
+    void apply(TourModifier& tour, const typename Operator::Move& move) const
+    {
+        Operator::for_each_removed_edge(tour, move, [this](primitives::point_id_t a, primitives::point_id_t b)
+        {
+            m_tabu.add(a, b);
+        });
+        Operator::apply(tour, move);
+        m_tabu.step();
+    }
+
+private:
+    TabuList& m_tabu;
+    const primitives::length_t m_aspiration_length {0};
+};
@@ -1,14 +1,34 @@
 #include "TourModifier.h"
 
-TourModifier::TourModifier(const std::vector<primitives::point_id_t>& initial_tour
-     , const std::vector<primitives::space_t>& x
-     , const std::vector<primitives::space_t>& y)
-    : m_length_map(initial_tour, x, y)
+TourModifier::TourModifier(const std::vector<primitives::point_id_t>& initial_tour, std::shared_ptr<const Instance> instance)
+    : m_length_map(initial_tour, std::move(instance))
     , m_adjacents(initial_tour.size(), {constants::invalid_point, constants::invalid_point})
     , m_next(initial_tour.size(), constants::invalid_point)
 {
     reset_adjacencies(initial_tour);
     update_next();
+    m_length = sum_lengths();
+}
+
+TourModifier::TourModifier(const std::vector<primitives::point_id_t>& initial_tour
+     , const std::vector<primitives::space_t>& x
+     , const std::vector<primitives::space_t>& y
+     , std::shared_ptr<const DistanceMatrix> matrix)
+    : TourModifier(initial_tour, std::make_shared<const Instance>(x, y, matrix))
+{
+}
+
+void TourModifier::reset(const std::vector<primitives::point_id_t>& initial_tour, std::shared_ptr<const Instance> instance)
+{
+    m_length_map.reset(initial_tour, std::move(instance));
+    m_adjacents.assign(initial_tour.size(), {constants::invalid_point, constants::invalid_point});
+    m_next.assign(initial_tour.size(), constants::invalid_point);
+    m_hash = 0;
+    m_fixed.reset();
+    m_batch = false;
+    reset_adjacencies(initial_tour);
+    update_next();
+    m_length = sum_lengths();
 }
 
 void TourModifier::reset_adjacencies(const std::vector<primitives::point_id_t>& initial_tour)
@@ -39,7 +59,7 @@ primitives::point_id_t TourModifier::prev(primitives::point_id_t i) const
     }
 }
 
-primitives::length_t TourModifier::length() const
+primitives::length_t TourModifier::sum_lengths() const
 {
     primitives::length_t sum {0};
     for (primitives::point_id_t i {0}; i < m_next.size(); ++i)
@@ -81,32 +101,156 @@ std::vector<primitives::point_id_t> TourModifier::order() const
 
 void TourModifier::move(primitives::point_id_t a, primitives::point_id_t b)
 {
+    if (m_journal)
+    {
+        m_journal->record(MoveJournal::Kind::Move, a, b);
+    }
+    m_length -= length(a) + length(b);
     m_length_map.erase(a, m_next[a]);
     m_length_map.erase(b, m_next[b]);
     m_length_map.insert(a, b);
     m_length_map.insert(m_next[a], m_next[b]);
+    m_length += m_length_map.length(a, b) + m_length_map.length(m_next[a], m_next[b]);
     break_adjacency(a);
     break_adjacency(b);
     create_adjacency(a, b);
     create_adjacency(m_next[a], m_next[b]);
-    update_next();
+    if (not m_batch)
+    {
+        update_next();
+    }
 }
 
 void TourModifier::vmove(primitives::point_id_t v, primitives::point_id_t n)
 {
+    if (m_journal)
+    {
+        m_journal->record(MoveJournal::Kind::VMove, v, n);
+    }
     const auto prev_v {prev(v)};
+    m_length -= length(v) + length(prev_v) + length(n);
     m_length_map.erase(v, m_next[v]);
     m_length_map.erase(v, prev_v);
     m_length_map.erase(n, m_next[n]);
     m_length_map.insert(v, n);
     m_length_map.insert(v, m_next[n]);
     m_length_map.insert(prev_v, m_next[v]);
+    m_length += m_length_map.length(v, n) + m_length_map.length(v, m_next[n]) + m_length_map.length(prev_v, m_next[v]);
     break_adjacency(v);
     break_adjacency(prev_v);
     break_adjacency(n);
     create_adjacency(v, n);
     create_adjacency(v, m_next[n]);
     create_adjacency(prev_v, m_next[v]);
+    if (not m_batch)
+    {
+        update_next();
+    }
+}
+
+void TourModifier::begin_batch()
+{
+    if (m_journal)
+    {
+        std::cout << __func__ << ": error: batches of moves cannot be journaled." << std::endl;
+        std::abort();
+    }
+    m_batch = true;
+}
+
+void TourModifier::end_batch()
+{
+    m_batch = false;
+    update_next();
+    // moves that do not commute split the tour into several cycles.
+    primitives::point_id_t count {1};
+    for (auto current {m_next[0]}; current != 0; current = m_next[current])
+    {
+        ++count;
+    }
+    if (count != m_next.size())
+    {
+        std::cout << __func__ << ": error: batch split the tour (" << count << " of " << m_next.size() << " points in cycle)." << std::endl;
+        std::abort();
+    }
+}
+
+void TourModifier::insert(primitives::point_id_t p, primitives::point_id_t after, std::shared_ptr<const Instance> instance)
+{
+    if (p != size() or instance->size() != size() + 1 or m_fixed)
+    {
+        std::cout << __func__ << ": error: the new point must be appended to the instance, without fixed edges." << std::endl;
+        std::abort();
+    }
+    const auto before_next {m_next[after]};
+    m_length -= length(after);
+    m_length_map.erase(after, before_next);
+    break_adjacency(after, before_next);
+    m_length_map.set_instance(std::move(instance));
+    m_adjacents.push_back({constants::invalid_point, constants::invalid_point});
+    m_next.push_back(constants::invalid_point);
+    for (auto other : {after, before_next})
+    {
+        m_length_map.insert(p, other);
+        create_adjacency(p, other);
+        m_length += m_length_map.length(p, other);
+    }
+    update_next();
+}
+
+void TourModifier::remove(primitives::point_id_t p, std::shared_ptr<const Instance> instance)
+{
+    // fewer points would leave the two neighbors of p joined twice.
+    if (size() < 4 or instance->size() + 1 != size() or m_fixed)
+    {
+        std::cout << __func__ << ": error: can only remove one point from a tour of at least 4 points without fixed edges." << std::endl;
+        std::abort();
+    }
+    auto before {prev(p)};
+    auto after {m_next[p]};
+    m_length -= length(before) + length(p);
+    for (auto other : {before, after})
+    {
+        m_length_map.erase(p, other);
+        break_adjacency(p, other);
+    }
+    // the last point moves to the id p; its segments keep their lengths.
+    const primitives::point_id_t last = size() - 1;
+    Adjacents moved {constants::invalid_point, constants::invalid_point};
+    if (last != p)
+    {
+        // if last was a neighbor of p, one of its slots is already empty.
+        moved = m_adjacents[last];
+        for (auto other : moved)
+        {
+            if (other == constants::invalid_point)
+            {
+                continue;
+            }
+            m_length_map.erase(last, other);
+            break_adjacency(last, other);
+        }
+        before = before == last ? p : before;
+        after = after == last ? p : after;
+    }
+    m_length_map.set_instance(std::move(instance));
+    m_adjacents.pop_back();
+    m_next.pop_back();
+    if (last != p)
+    {
+        for (auto other : moved)
+        {
+            if (other == constants::invalid_point)
+            {
+                continue;
+            }
+            m_length_map.insert(p, other);
+            create_adjacency(p, other);
+        }
+    }
+    m_length_map.insert(before, after);
+    create_adjacency(before, after);
+    m_length += m_length_map.length(before, after);
     update_next();
 }
 
@@ -139,6 +283,7 @@ void TourModifier::create_adjacency(primitives::point_id_t point1, primitives::p
 {
     fill_adjacent(point1, point2);
     fill_adjacent(point2, point1);
+    m_hash ^= edge_hash(point1, point2);
 }
 
 void TourModifier::fill_adjacent(primitives::point_id_t point, primitives::point_id_t new_adjacent)
@@ -170,6 +315,7 @@ void TourModifier::break_adjacency(primitives::point_id_t point1, primitives::po
     vacate_adjacent_slot(point1, point2, 1);
     vacate_adjacent_slot(point2, point1, 0);
     vacate_adjacent_slot(point2, point1, 1);
+    m_hash ^= edge_hash(point1, point2);
 }
 
 void TourModifier::vacate_adjacent_slot(primitives::point_id_t point, primitives::point_id_t adjacent, int slot)
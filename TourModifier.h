@@ -1,11 +1,16 @@
 #pragma once
 
 #include <array>
+#include <cstdint>
 #include <cstdlib> // abort
 #include <iostream>
+#include <memory> // shared_ptr
 #include <vector>
 
+#include "FixedEdges.h"
+#include "Instance.h"
 #include "LengthMap.h"
+#include "MoveJournal.h"
 #include "constants.h"
 #include "primitives.h"
 
@@ -13,27 +18,79 @@ class TourModifier
 {
     using Adjacents = std::array<primitives::point_id_t, 2>;
 public:
+    // Copies of the tour share instance.
+    TourModifier(const std::vector<primitives::point_id_t>& initial_tour, std::shared_ptr<const Instance> instance);
+    // Creates an instance for the tour alone (see Instance).
     TourModifier(const std::vector<primitives::point_id_t>& initial_tour
          , const std::vector<primitives::space_t>& x
-         , const std::vector<primitives::space_t>& y);
+         , const std::vector<primitives::space_t>& y
+         , std::shared_ptr<const DistanceMatrix> matrix = nullptr);
+
+    // Reinitializes for a new tour, reusing allocated storage.
+    void reset(const std::vector<primitives::point_id_t>& initial_tour, std::shared_ptr<const Instance> instance);
 
     void move(primitives::point_id_t a, primitives::point_id_t b);
     void vmove(primitives::point_id_t v, primitives::point_id_t n);
+
+    // Between begin_batch() and end_batch(), moves leave next() and prev() as they were before the batch, and
+    // end_batch() updates them once instead of after every move. So moves of a batch must touch disjoint points
+    // and must reconnect a single tour in any order (see batch_improvements of the operators); a batch is not
+    // journaled, as the journal replays moves one at a time.
+    void begin_batch();
+    void end_batch();
+
+    // Inserts the new point p == size() between after and next(after);
+    // instance is the current instance with p appended. Neither insertion nor removal works with fixed edges.
+    void insert(primitives::point_id_t p, primitives::point_id_t after, std::shared_ptr<const Instance> instance);
+    // Removes p, joining prev(p) and next(p), and gives the last point the id p;
+    // instance is the current instance renumbered the same way.
+    void remove(primitives::point_id_t p, std::shared_ptr<const Instance> instance);
+
     primitives::point_id_t next(primitives::point_id_t i) const { return m_next[i]; }
     primitives::point_id_t prev(primitives::point_id_t i) const;
     std::vector<primitives::point_id_t> order() const;
     primitives::point_id_t size() const { return m_next.size(); }
 
-    primitives::length_t length() const;
+    primitives::length_t length() const { return m_length; } // kept up to date by all modifications.
     primitives::length_t length(primitives::point_id_t i) const;
     primitives::length_t prev_length(primitives::point_id_t i) const;
 
+    // Moves must not remove fixed edges; the climbs and perturbations skip them. Copies share the fixed edges.
+    void set_fixed(std::shared_ptr<const FixedEdges> fixed) { m_fixed = std::move(fixed); }
+    const std::shared_ptr<const FixedEdges>& fixed() const { return m_fixed; }
+    // Whether the segment (i, next(i)) is fixed.
+    bool fixed(primitives::point_id_t i) const { return m_fixed and m_fixed->contains(i, m_next[i]); }
+
+    // Hash of the edge set, independent of direction and starting point; kept up to date by all modifications.
+    uint64_t hash() const { return m_hash; }
+
     const LengthMap& length_map() const { return m_length_map; }
+    const std::shared_ptr<const Instance>& instance() const { return m_length_map.instance(); }
+
+    // If set, every move (but not insertions and removals) is recorded to the journal. Copies share the journal pointer.
+    void set_journal(MoveJournal* journal) { m_journal = journal; }
+    MoveJournal* journal() const { return m_journal; }
 
 private:
     LengthMap m_length_map;
     std::vector<Adjacents> m_adjacents;
     std::vector<primitives::point_id_t> m_next;
+    primitives::length_t m_length {0};
+    uint64_t m_hash {0}; // xor of the hashes of all edges.
+    MoveJournal* m_journal {nullptr};
+    std::shared_ptr<const FixedEdges> m_fixed;
+    bool m_batch {false};
+
+    // Mixes the edge key (splitmix64 finalizer), standing in for a table of random edge values.
+    static uint64_t edge_hash(primitives::point_id_t a, primitives::point_id_t b)
+    {
+        uint64_t h {a < b ? (static_cast<uint64_t>(a) << 32) | b : (static_cast<uint64_t>(b) << 32) | a};
+        h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+        h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+        return h ^ (h >> 31);
+    }
+
+    primitives::length_t sum_lengths() const;
 
     void reset_adjacencies(const std::vector<primitives::point_id_t>& initial_tour);
     void update_next();
@@ -0,0 +1,50 @@
+#include "TourWriter.h"
+
+#include "fileio.h"
+
+TourWriter::TourWriter()
+    : m_thread(&TourWriter::run, this)
+{
+}
+
+TourWriter::~TourWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_done = true;
+    }
+    m_condition.notify_one();
+    m_thread.join();
+}
+
+void TourWriter::save(std::vector<primitives::point_id_t> ordered_points, std::string output_filename)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending.swap(ordered_points);
+        m_pending_filename.swap(output_filename);
+        m_has_pending = true;
+    }
+    m_condition.notify_one();
+}
+
+void TourWriter::run()
+{
+    std::vector<primitives::point_id_t> ordered_points;
+    std::string output_filename;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_condition.wait(lock, [this] { return m_done or m_has_pending; });
+        if (not m_has_pending)
+        {
+            return; // done.
+        }
+        ordered_points.swap(m_pending);
+        output_filename.swap(m_pending_filename);
+        m_has_pending = false;
+        lock.unlock();
+        fileio::write_ordered_points(ordered_points, output_filename);
+        lock.lock();
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+// Writes tours on a separate thread, so that saving never stalls the search.
+// Only the most recent pending tour is kept: a newer tour replaces one that has not been written yet.
+
+#include "primitives.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class TourWriter
+{
+public:
+    TourWriter();
+    ~TourWriter(); // writes the pending tour before returning.
+
+    TourWriter(const TourWriter&) = delete;
+    TourWriter& operator=(const TourWriter&) = delete;
+
+    void save(std::vector<primitives::point_id_t> ordered_points, std::string output_filename);
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::vector<primitives::point_id_t> m_pending;
+    std::string m_pending_filename;
+    bool m_has_pending {false};
+    bool m_done {false};
+    std::thread m_thread; // last, so that it starts after the other members.
+
+    void run();
+};
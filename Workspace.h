@@ -0,0 +1,79 @@
+#pragma once
+
+// Storage reused by the perturbation trials of one thread,
+// so that the steady-state perturbation loop does not allocate.
+
+#include "Beam.h"
+#include "MoveJournal.h"
+#include "PointQueue.h"
+#include "TabuList.h"
+#include "TourModifier.h"
+
+#include <cstddef> // size_t
+#include <optional>
+#include <vector>
+
+template <typename SwapType>
+struct Workspace
+{
+    std::vector<SwapType> swaps; // perturbations of the current cost level.
+    std::optional<TourModifier> trial;
+    std::optional<TourModifier> best; // best trial of the current cost level, across threads.
+    PointQueue repair_queue;
+    PointQueue touched;
+    TabuList tabu; // of the current trial.
+    MoveJournal journal; // moves of the current trial, if the original tour is journaled.
+    MoveJournal best_journal; // moves of the best trial.
+    // beam search (see lateral::beam_climb): the levels being expanded and filled,
+    // and the perturbations of the expanded level with the beam tours they apply to.
+    Beam beam;
+    Beam next_beam;
+    std::vector<SwapType> beam_swaps;
+    std::vector<size_t> beam_origins;
+
+    // Copies the tour into target, reusing target's storage when it already holds a tour.
+    static TourModifier& assign(std::optional<TourModifier>& target, const TourModifier& tour)
+    {
+        if (target)
+        {
+            *target = tour;
+        }
+        else
+        {
+            target.emplace(tour);
+        }
+        return *target;
+    }
+
+    // Returns the trial tour, set to a copy of tour, with empty queues sized for it.
+    // If tour is journaled, the trial records its moves to this workspace's journal instead.
+    TourModifier& start_trial(const TourModifier& tour)
+    {
+        repair_queue.reset(tour.size());
+        touched.reset(tour.size());
+        journal.clear();
+        auto& new_tour {assign(trial, tour)};
+        new_tour.set_journal(tour.journal() ? &journal : nullptr);
+        return new_tour;
+    }
+
+    // Replaces tour with the best trial, appending the best trial's moves to tour's journal.
+    void accept_best(TourModifier& tour) const
+    {
+        auto* tour_journal {tour.journal()};
+        tour = *best;
+        tour.set_journal(tour_journal);
+        if (tour_journal)
+        {
+            tour_journal->append(best_journal);
+        }
+    }
+};
+
+// One workspace per thread and swap type; the worker threads of parallel::pool() keep theirs between cost levels.
+template <typename SwapType>
+Workspace<SwapType>& workspace()
+{
+    thread_local Workspace<SwapType> w;
+    return w;
+}
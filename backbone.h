@@ -0,0 +1,86 @@
+#pragma once
+
+// Problem reduction: edges shared by several independent local optima are very likely in good tours,
+// so fixing them (see FixedEdges) leaves the expensive perturbation search only the remaining edges.
+
+#include "FixedEdges.h"
+#include "SearchContext.h"
+#include "TourModifier.h"
+#include "parallel.h"
+#include "primitives.h"
+#include "solver.h"
+#include "twoopt/uncross.h"
+
+#include <algorithm> // remove_if, shuffle
+#include <memory> // shared_ptr
+#include <numeric> // iota
+#include <random>
+#include <vector>
+
+namespace backbone {
+
+// Climbs from climb_count random tours (untangled first if uncross, see twoopt::uncross)
+// with the operators and on the threads of context, and returns the edges of tour that all of them share.
+// No climb starts once context has expired; if fewer than two climbs finished, returns nullptr (nothing to fix).
+inline std::shared_ptr<const FixedEdges> find(const TourModifier& tour
+    , primitives::point_id_t climb_count
+    , const SearchContext& context
+    , bool uncross = false)
+{
+    const primitives::point_id_t n = tour.size();
+    // empty for climbs that did not start.
+    std::vector<std::vector<primitives::point_id_t>> climbed(climb_count);
+    parallel::for_each(climb_count, context.threads(), [&](size_t c)
+    {
+        if (context.expired())
+        {
+            return;
+        }
+        std::vector<primitives::point_id_t> order(n);
+        std::iota(order.begin(), order.end(), 0);
+        std::mt19937 random(c);
+        std::shuffle(order.begin(), order.end(), random);
+        TourModifier start(order, tour.instance());
+        if (uncross)
+        {
+            twoopt::uncross::remove_crossings(start);
+        }
+        solver::multi_climb(start, context.operators());
+        climbed[c] = start.order();
+    });
+    climbed.erase(std::remove_if(climbed.begin(), climbed.end(), [](const auto& order) { return order.empty(); })
+        , climbed.end());
+    if (climbed.size() < 2)
+    {
+        return nullptr;
+    }
+    // whether all climbs contain the edge (i, next(i)) of tour.
+    std::vector<bool> shared(n, true);
+    for (const auto& order : climbed)
+    {
+        std::vector<primitives::point_id_t> next(n);
+        for (primitives::point_id_t i {0}; i < n; ++i)
+        {
+            next[order[i]] = order[(i + 1) % n];
+        }
+        for (primitives::point_id_t i {0}; i < n; ++i)
+        {
+            const auto j {tour.next(i)};
+            if (next[i] != j and next[j] != i)
+            {
+                shared[i] = false;
+            }
+        }
+    }
+    auto fixed {std::make_shared<FixedEdges>(n)};
+    for (primitives::point_id_t i {0}; i < n; ++i)
+    {
+        if (shared[i])
+        {
+            fixed->add(i, tour.next(i));
+        }
+    }
+    return fixed;
+}
+
+} // namespace backbone
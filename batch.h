@@ -0,0 +1,132 @@
+#pragma once
+
+// Solves many instances in one process: instances are taken by a fixed set of worker threads,
+// each of which keeps its coordinate buffers and Solver (and thus its tour storage) between instances.
+
+#include "Solver.h"
+#include "fileio.h"
+#include "primitives.h"
+
+#include <algorithm> // max, sort
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory> // shared_ptr
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace batch {
+
+struct Result
+{
+    std::string instance;
+    primitives::point_id_t point_count {0};
+    primitives::length_t length {0};
+    double seconds {0};
+    std::string error; // why the instance could not be solved, empty if it was.
+};
+
+// Lists the instance files in a directory, or the paths in a manifest file (one per line; '#' starts a comment).
+inline std::vector<std::string> list_instances(const std::string& manifest_or_directory)
+{
+    std::vector<std::string> instances;
+    if (std::filesystem::is_directory(manifest_or_directory))
+    {
+        for (const auto& entry : std::filesystem::directory_iterator(manifest_or_directory))
+        {
+            if (entry.is_regular_file() and entry.path().extension() == ".tsp")
+            {
+                instances.push_back(entry.path().string());
+            }
+        }
+        std::sort(instances.begin(), instances.end());
+        return instances;
+    }
+    std::ifstream file_stream(manifest_or_directory);
+    if (not file_stream.is_open())
+    {
+        std::cout << __func__ << ": error: could not open manifest: " << manifest_or_directory << std::endl;
+        std::exit(EXIT_SUCCESS);
+    }
+    std::string line;
+    while (std::getline(file_stream, line))
+    {
+        line = line.substr(0, line.find('#'));
+        const auto first {line.find_first_not_of(" \t\r")};
+        if (first == std::string::npos)
+        {
+            continue;
+        }
+        const auto last {line.find_last_not_of(" \t\r")};
+        instances.push_back(line.substr(first, last - first + 1));
+    }
+    return instances;
+}
+
+inline std::vector<Result> solve(const std::vector<std::string>& instances
+    , const SolverOptions& options
+    , unsigned thread_count)
+{
+    std::vector<Result> results(instances.size());
+    std::atomic<size_t> next {0};
+    auto work = [&]()
+    {
+        std::vector<primitives::space_t> x, y;
+        std::shared_ptr<const DistanceMatrix> matrix;
+        Solver solver(options);
+        for (auto i {next++}; i < instances.size(); i = next++)
+        {
+            const auto start {std::chrono::steady_clock::now()};
+            auto& result {results[i]};
+            result.instance = instances[i];
+            // a bad instance must not end the batch (and lose the results of the others).
+            if (not fileio::try_read_instance(instances[i].c_str(), x, y, matrix, result.error, false))
+            {
+                continue;
+            }
+            solver.set_points(x, y);
+            solver.set_matrix(matrix);
+            solver.solve();
+            result.point_count = x.size();
+            result.length = solver.length();
+            result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+    };
+    thread_count = std::max(thread_count, 1u);
+    std::vector<std::thread> threads;
+    for (unsigned t {1}; t < thread_count; ++t)
+    {
+        threads.emplace_back(work);
+    }
+    work();
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+    return results;
+}
+
+inline void write_results(const std::vector<Result>& results, const std::string& output_filename)
+{
+    std::ofstream output_file(output_filename);
+    if (not output_file.is_open())
+    {
+        std::cout << __func__ << ": error: could not open results file: " << output_filename << std::endl;
+        std::exit(EXIT_SUCCESS);
+    }
+    // the error is last, as it contains spaces; "-" if the instance was solved.
+    output_file << "instance points length seconds error\n";
+    for (const auto& result : results)
+    {
+        output_file << result.instance
+            << " " << result.point_count
+            << " " << result.length
+            << " " << result.seconds
+            << " " << (result.error.empty() ? "-" : result.error) << "\n";
+    }
+}
+
+} // namespace batch
@@ -0,0 +1,152 @@
+#pragma once
+
+// Partition crossover (GPX) of local optima.
+// Edges present in only one parent form the components where the parents differ.
+// A component entered and left through exactly two shared edges is traversed by each parent
+// as a single path between the same two points, so either parent's path can be used there independently.
+// The child takes the better parent and substitutes the shorter path in every such component,
+// so it is never longer than either parent. Runs in O(n) apart from near-constant union-find factors.
+
+#include "TourModifier.h"
+#include "constants.h"
+#include "primitives.h"
+
+#include <array>
+#include <numeric> // iota
+#include <vector>
+
+namespace crossover {
+
+inline primitives::point_id_t find_root(std::vector<primitives::point_id_t>& parent, primitives::point_id_t i)
+{
+    while (parent[i] != i)
+    {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+inline bool has_edge(const std::array<primitives::point_id_t, 2>& adjacents, primitives::point_id_t j)
+{
+    return adjacents[0] == j or adjacents[1] == j;
+}
+
+// Returns the ordered points of the child of a and b, which must be tours of the same point set.
+inline std::vector<primitives::point_id_t> merge_order(const TourModifier& a, const TourModifier& b)
+{
+    using Adjacents = std::array<primitives::point_id_t, 2>;
+    const auto n {a.size()};
+    const bool a_is_base {a.length() <= b.length()};
+    const auto& base {a_is_base ? a : b};
+    const auto& other {a_is_base ? b : a};
+    std::vector<Adjacents> base_adjacents(n);
+    std::vector<Adjacents> other_adjacents(n);
+    for (primitives::point_id_t i {0}; i < n; ++i)
+    {
+        base_adjacents[i] = {base.prev(i), base.next(i)};
+        other_adjacents[i] = {other.prev(i), other.next(i)};
+    }
+
+    // components of the edges not shared by both parents.
+    std::vector<primitives::point_id_t> component(n);
+    std::iota(component.begin(), component.end(), 0);
+    std::vector<bool> differs(n, false); // point has at least one unshared edge.
+    for (primitives::point_id_t i {0}; i < n; ++i)
+    {
+        for (const auto& adjacents : {base_adjacents[i], other_adjacents[i]})
+        {
+            for (auto j : adjacents)
+            {
+                if (not has_edge(base_adjacents[i], j) or not has_edge(other_adjacents[i], j))
+                {
+                    differs[i] = true;
+                    component[find_root(component, i)] = find_root(component, j);
+                }
+            }
+        }
+    }
+
+    // count shared edges crossing each component boundary, and the length of each parent inside.
+    std::vector<primitives::point_id_t> crossings(n, 0);
+    std::vector<primitives::length_t> base_length(n, 0);
+    std::vector<primitives::length_t> other_length(n, 0);
+    for (primitives::point_id_t i {0}; i < n; ++i)
+    {
+        if (not differs[i])
+        {
+            continue;
+        }
+        const auto root {find_root(component, i)};
+        for (auto j : base_adjacents[i])
+        {
+            if (not differs[j] or find_root(component, j) != root)
+            {
+                ++crossings[root];
+            }
+            else
+            {
+                base_length[root] += base.length_map().compute_length(i, j); // counted from both ends.
+            }
+        }
+        for (auto j : other_adjacents[i])
+        {
+            if (differs[j] and find_root(component, j) == root)
+            {
+                other_length[root] += other.length_map().compute_length(i, j);
+            }
+        }
+    }
+
+    // child adjacency: base everywhere except feasible components where the other parent is shorter.
+    auto child_adjacents {base_adjacents};
+    for (primitives::point_id_t i {0}; i < n; ++i)
+    {
+        if (not differs[i])
+        {
+            continue;
+        }
+        const auto root {find_root(component, i)};
+        if (crossings[root] == 2 and other_length[root] < base_length[root])
+        {
+            child_adjacents[i] = other_adjacents[i];
+        }
+    }
+
+    // walk the child; if it is somehow not a single cycle, fall back to the base parent.
+    std::vector<primitives::point_id_t> order;
+    order.reserve(n);
+    primitives::point_id_t previous {child_adjacents[0][0]};
+    primitives::point_id_t current {0};
+    do
+    {
+        order.push_back(current);
+        const auto& adjacents {child_adjacents[current]};
+        const auto next {adjacents[0] == previous ? adjacents[1] : adjacents[0]};
+        previous = current;
+        current = next;
+    } while (current != 0 and order.size() <= n);
+    if (order.size() != n)
+    {
+        return base.order();
+    }
+    return order;
+}
+
+inline TourModifier merge(const TourModifier& a, const TourModifier& b)
+{
+    return TourModifier(merge_order(a, b), a.instance());
+}
+
+// Merges all tours pairwise in sequence; the result is never longer than the shortest tour.
+inline TourModifier merge(const std::vector<TourModifier>& tours)
+{
+    auto child {tours.front()};
+    for (size_t i {1}; i < tours.size(); ++i)
+    {
+        child = merge(child, tours[i]);
+    }
+    return child;
+}
+
+} // namespace crossover
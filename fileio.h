@@ -1,9 +1,15 @@
 #pragma once
 
+#include "DistanceMatrix.h"
 #include "primitives.h"
 
-#include <array>
+#include <charconv> // to_chars
+#include <cstdlib> // abort, exit
+#include <filesystem>
 #include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory> // shared_ptr, make_shared
 #include <sstream>
 #include <string>
 #include <vector>
@@ -27,17 +33,47 @@ inline std::string extract_filename(const char* file_path)
     return filename;
 }
 
-inline void write_ordered_points(const std::vector<primitives::point_id_t>& ordered_points
+// Formats the whole file in memory, writes it to a temporary file in one call and renames it into place,
+// so readers never see a partial tour. Creates missing directories. Returns false on failure.
+inline bool write_ordered_points(const std::vector<primitives::point_id_t>& ordered_points
     , const std::string output_filename)
 {
-    std::ofstream output_file;
-    output_file.open(output_filename);
-    output_file << "DIMENSION: " << ordered_points.size() << "\n";
-    output_file << "TOUR_SECTION\n";
+    std::string buffer;
+    buffer.reserve(32 + ordered_points.size() * (std::numeric_limits<primitives::point_id_t>::digits10 + 2));
+    buffer += "DIMENSION: " + std::to_string(ordered_points.size()) + "\n";
+    buffer += "TOUR_SECTION\n";
+    char number[std::numeric_limits<primitives::point_id_t>::digits10 + 2];
     for (auto p : ordered_points)
     {
-        output_file << p + 1 << "\n";
+        const auto end {std::to_chars(number, number + sizeof(number), p + 1).ptr};
+        buffer.append(number, end);
+        buffer += '\n';
     }
+
+    const std::filesystem::path path(output_filename);
+    std::error_code error;
+    if (path.has_parent_path())
+    {
+        std::filesystem::create_directories(path.parent_path(), error);
+    }
+    const auto temporary_path {output_filename + ".tmp"};
+    {
+        std::ofstream output_file(temporary_path, std::ios::binary);
+        output_file.write(buffer.data(), buffer.size());
+        if (not output_file)
+        {
+            std::cout << __func__ << ": error: could not write file: " << temporary_path << std::endl;
+            return false;
+        }
+    }
+    std::filesystem::rename(temporary_path, path, error);
+    if (error)
+    {
+        std::cout << __func__ << ": error: could not rename " << temporary_path
+            << " to " << output_filename << ": " << error.message() << std::endl;
+        return false;
+    }
+    return true;
 }
 
 inline std::vector<primitives::point_id_t> read_ordered_points(const char* file_path)
@@ -88,38 +124,22 @@ inline std::vector<primitives::point_id_t> read_ordered_points(const char* file_
     return point_ids;
 }
 
-inline std::vector<primitives::point_id_t> default_tour(primitives::point_id_t point_count)
+// Reads into x and y, reusing their storage. Returns false, with the reason in error, if the file cannot be read.
+inline bool try_read_coordinates(const char* file_path
+    , std::vector<primitives::space_t>& x
+    , std::vector<primitives::space_t>& y
+    , std::string& error
+    , bool verbose = true)
 {
-    std::vector<primitives::point_id_t> tour;
-    for (primitives::point_id_t i{0}; i < point_count; ++i)
+    if (verbose)
     {
-        tour.push_back(i);
+        std::cout << "\nReading point set file: " << file_path << std::endl;
     }
-    return tour;
-}
-
-inline std::vector<primitives::point_id_t> initial_tour(int argc, const char** argv, primitives::point_id_t point_count)
-{
-    std::vector<primitives::point_id_t> tour;
-    if (argc > 2)
-    {
-        tour = read_ordered_points(argv[2]);
-    }
-    else
-    {
-        tour = default_tour(point_count);
-    }
-    return tour;
-}
-
-inline std::array<std::vector<primitives::space_t>, 2> read_coordinates(const char* file_path)
-{
-    std::cout << "\nReading point set file: " << file_path << std::endl;
     std::ifstream file_stream(file_path);
     if (not file_stream.is_open())
     {
-        std::cout << "Could not open file: " << file_path << std::endl;
-        std::exit(EXIT_SUCCESS);
+        error = std::string("Could not open file: ") + file_path;
+        return false;
     }
     size_t point_count{0};
     // header.
@@ -133,19 +153,23 @@ inline std::array<std::vector<primitives::space_t>, 2> read_coordinates(const ch
         }
         if (line.find("DIMENSION") != std::string::npos) // point count.
         {
-            std::string point_count_string = line.substr(line.find(':') + 1);
-            point_count = std::stoi(point_count_string);
-            std::cout << "Number of points according to header: " << point_count << std::endl;
+            std::stringstream point_count_stream(line.substr(line.find(':') + 1));
+            point_count_stream >> point_count;
+            if (verbose)
+            {
+                std::cout << "Number of points according to header: " << point_count << std::endl;
+            }
         }
     }
     if (point_count == 0)
     {
-        std::cout << "Could not read any points from the point set file." << std::endl;
-        std::exit(EXIT_SUCCESS);
+        error = std::string("Could not read any points from the point set file: ") + file_path;
+        return false;
     }
 
     // read coordinates.
-    std::vector<primitives::space_t> x, y;
+    x.clear();
+    y.clear();
     while (not file_stream.eof())
     {
         if (x.size() >= point_count)
@@ -166,16 +190,180 @@ inline std::array<std::vector<primitives::space_t>, 2> read_coordinates(const ch
         }
         else
         {
-            std::cout << __func__ << ": error: point id ("
-                << point_id
-                << ") does not match number of currently read points ("
-                << x.size()
-                << ")." << std::endl;
-            std::exit(EXIT_SUCCESS);
+            error = std::string(__func__) + ": error: point id (" + std::to_string(point_id)
+                + ") does not match number of currently read points (" + std::to_string(x.size()) + ").";
+            return false;
+        }
+    }
+    if (verbose)
+    {
+        std::cout << "Finished reading point set file.\n" << std::endl;
+    }
+    return true;
+}
+
+// Like try_read_coordinates, but exits if the file cannot be read.
+inline void read_coordinates(const char* file_path
+    , std::vector<primitives::space_t>& x
+    , std::vector<primitives::space_t>& y
+    , bool verbose = true)
+{
+    std::string error;
+    if (not try_read_coordinates(file_path, x, y, error, verbose))
+    {
+        std::cout << error << std::endl;
+        std::exit(EXIT_SUCCESS);
+    }
+}
+
+// Returns the value of a "KEY: VALUE" header line, without surrounding whitespace.
+inline std::string header_value(const std::string& line)
+{
+    auto value {line.substr(line.find(':') + 1)};
+    const auto first {value.find_first_not_of(" \t\r")};
+    if (first == std::string::npos)
+    {
+        return {};
+    }
+    return value.substr(first, value.find_last_not_of(" \t\r") - first + 1);
+}
+
+// Returns true if the instance file lists its lengths explicitly (EDGE_WEIGHT_TYPE: EXPLICIT).
+inline bool is_explicit(const char* file_path)
+{
+    std::ifstream file_stream(file_path);
+    std::string line;
+    while (std::getline(file_stream, line))
+    {
+        if (line.find("NODE_COORD_SECTION") != std::string::npos or line.find("EDGE_WEIGHT_SECTION") != std::string::npos)
+        {
+            break;
+        }
+        if (line.find("EDGE_WEIGHT_TYPE") != std::string::npos)
+        {
+            return header_value(line) == "EXPLICIT";
+        }
+    }
+    return false;
+}
+
+// Returns false, with the reason in error, if the file cannot be read.
+inline bool try_read_explicit_lengths(const char* file_path
+    , std::shared_ptr<const DistanceMatrix>& matrix
+    , std::string& error
+    , bool verbose = true)
+{
+    if (verbose)
+    {
+        std::cout << "\nReading explicit instance file: " << file_path << std::endl;
+    }
+    std::ifstream file_stream(file_path);
+    if (not file_stream.is_open())
+    {
+        error = std::string("Could not open file: ") + file_path;
+        return false;
+    }
+    size_t point_count {0};
+    std::string format {"FULL_MATRIX"};
+    std::string line;
+    while (std::getline(file_stream, line))
+    {
+        if (line.find("EDGE_WEIGHT_SECTION") != std::string::npos) // header end.
+        {
+            break;
+        }
+        if (line.find("DIMENSION") != std::string::npos)
+        {
+            std::stringstream point_count_stream(header_value(line));
+            point_count_stream >> point_count;
+        }
+        if (line.find("EDGE_WEIGHT_FORMAT") != std::string::npos)
+        {
+            format = header_value(line);
+        }
+    }
+    if (point_count == 0)
+    {
+        error = std::string(__func__) + ": error: no DIMENSION header in the instance file: " + file_path;
+        return false;
+    }
+    const auto expected {DistanceMatrix::weight_count(point_count, format)};
+    if (not expected)
+    {
+        error = std::string(__func__) + ": error: unsupported EDGE_WEIGHT_FORMAT: " + format;
+        return false;
+    }
+    // weights run until the next section or EOF.
+    std::vector<primitives::length_t> weights;
+    while (std::getline(file_stream, line))
+    {
+        if (line.find("SECTION") != std::string::npos or line.find("EOF") != std::string::npos)
+        {
+            break;
         }
+        std::stringstream line_stream(line);
+        double weight {0};
+        while (line_stream >> weight)
+        {
+            weights.push_back(weight + 0.5);
+        }
+    }
+    if (verbose)
+    {
+        std::cout << "Read " << weights.size() << " " << format << " weights for " << point_count << " points.\n" << std::endl;
+    }
+    if (weights.size() < *expected)
+    {
+        error = std::string(__func__) + ": error: expected " + std::to_string(*expected)
+            + " weights but read " + std::to_string(weights.size()) + ".";
+        return false;
+    }
+    if (not DistanceMatrix::fits(weights))
+    {
+        error = std::string(__func__) + ": error: weights do not fit in 32 bits.";
+        return false;
+    }
+    matrix = std::make_shared<const DistanceMatrix>(DistanceMatrix::from_explicit(point_count, format, weights));
+    return true;
+}
+
+// Reads a coordinate instance into x and y (and resets matrix),
+// or an explicit instance into matrix (and zero-filled x and y of the point count).
+// Returns false, with the reason in error, if the file cannot be read.
+inline bool try_read_instance(const char* file_path
+    , std::vector<primitives::space_t>& x
+    , std::vector<primitives::space_t>& y
+    , std::shared_ptr<const DistanceMatrix>& matrix
+    , std::string& error
+    , bool verbose = true)
+{
+    if (not is_explicit(file_path))
+    {
+        matrix.reset();
+        return try_read_coordinates(file_path, x, y, error, verbose);
+    }
+    if (not try_read_explicit_lengths(file_path, matrix, error, verbose))
+    {
+        return false;
+    }
+    x.assign(matrix->size(), 0);
+    y.assign(matrix->size(), 0);
+    return true;
+}
+
+// Like try_read_instance, but exits if the file cannot be read.
+inline void read_instance(const char* file_path
+    , std::vector<primitives::space_t>& x
+    , std::vector<primitives::space_t>& y
+    , std::shared_ptr<const DistanceMatrix>& matrix
+    , bool verbose = true)
+{
+    std::string error;
+    if (not try_read_instance(file_path, x, y, matrix, error, verbose))
+    {
+        std::cout << error << std::endl;
+        std::exit(EXIT_SUCCESS);
     }
-    std::cout << "Finished reading point set file.\n" << std::endl;
-    return {x, y};
 }
 
 } // namespace fileio
@@ -1,157 +1,260 @@
 #pragma once
 
-#include "Pair.h"
-#include "Swap.h"
+// Lateral perturbation with any operator (see OperatorSet.h).
+// Each trial applies a move of some cost, repairs the tour around it, and climbs;
+// the first trial that ends up shorter than the original tour replaces it.
+// Edges removed by the perturbation stay tabu for the whole trial, and edges removed by the repair and climb
+// for a tenure of moves, so that trials make progress instead of falling back into the original tour.
+// Costs are tried in increasing order, starting from 0 (moves that keep the length).
+// Trials that reach a local optimum explored before (see OptimaCache) are abandoned without climbing on.
+// Optionally, a beam search perturbs the best non-improving trials again (see beam_climb).
+
+#include "Beam.h"
+#include "MoveJournal.h"
+#include "NeighborLists.h"
+#include "OperatorSet.h"
+#include "PointQueue.h"
+#include "SearchContext.h"
+#include "TabuRules.h"
 #include "TourModifier.h"
+#include "Workspace.h"
+#include "constants.h"
+#include "parallel.h"
+#include "primitives.h"
+#include "profile.h"
 #include "solver.h"
 
-#include <algorithm> // min
+#include <algorithm> // max
+#include <mutex>
+#include <utility> // swap
+#include <vector>
 
 namespace lateral {
 
-inline bool is_valid_move(const TourModifier& tour
-    , primitives::point_id_t i
-    , primitives::point_id_t j
-    , primitives::length_t current_length
-    , primitives::length_t desired_cost
-    , primitives::length_t& next_cost)
+// Repairs the tour around a perturbation with moves of its operator, starting from the queued points.
+// Adds all points touched by the repair to touched, to seed the subsequent climb.
+// Given neighbor lists, only moves adding a segment between a queued point and one of its neighbors are searched.
+template <typename Operator>
+void restricted_repair(TourModifier& tour
+    , const TabuRules& rules
+    , PointQueue& repair_queue
+    , PointQueue& touched
+    , const NeighborLists* neighbors = nullptr)
 {
-    auto new_length {tour.length_map().compute_length(i, j)};
-    new_length += tour.length_map().compute_length(tour.next(i), tour.next(j));
-    const auto target_length {current_length + desired_cost};
-    if (new_length > target_length)
+    while (not repair_queue.empty())
     {
-        next_cost = std::min(next_cost, desired_cost + new_length - target_length);
+        const auto i {repair_queue.pop()};
+        const auto move {solver::point_improvement<Operator>(tour, i, rules, neighbors)};
+        if (move.improvement == 0)
+        {
+            continue;
+        }
+        Operator::for_each_endpoint(tour, move, [&repair_queue, &touched](primitives::point_id_t p)
+        {
+            repair_queue.push(p);
+            touched.push(p);
+        });
+        rules.apply<Operator>(tour, move);
     }
-    return new_length == target_length;
 }
 
-inline std::vector<Swap> find_swaps(const TourModifier& tour
-    , primitives::length_t cost
-    , primitives::length_t& next_cost)
+// Tour a trial perturbs, and the moves that led to it from the original tour (none for the original itself).
+struct TrialStart
 {
-    std::vector<Swap> swaps;
-    constexpr primitives::point_id_t start {0};
-    // first segment cannot be compared with last segment.
-    auto end {tour.prev(start)};
-    const auto first_old_length {tour.length(start)};
-    for (primitives::point_id_t i {tour.next(tour.next(start))}; i != end; i = tour.next(i))
-    {
-        const auto current_length {first_old_length + tour.length(i)};
-        if (is_valid_move(tour, start, i, current_length, cost, next_cost))
-        {
-            swaps.push_back({start, i, cost});
-        }
-    }
+    const TourModifier& tour;
+    const MoveJournal* prefix {nullptr};
+};
 
-    end = tour.prev(end);
-    for (primitives::point_id_t i {tour.next(start)}; i != end; i = tour.next(i))
+// Runs the trials of moves, each applied to start(i), until one ends up shorter than original_length.
+// Returns true and leaves the first such trial (in move order) in the calling thread's workspace.
+// Non-improving trials are offered to beam, if given. Trials climb with climb_operators.
+template <typename Operator, typename... ClimbOperator, typename Start>
+bool run_trials(OperatorSet<ClimbOperator...> climb_operators
+    , const std::vector<typename Operator::Move>& moves
+    , const Start& start
+    , primitives::length_t original_length
+    , const SearchContext& context
+    , Beam* beam = nullptr)
+{
+    using Move = typename Operator::Move;
+    constexpr auto removed_edge_count {std::max({Operator::removed_edge_count, ClimbOperator::removed_edge_count...})};
+    auto& best_workspace {workspace<Move>()}; // of the calling thread, filled by any thread.
+    std::mutex mutex;
+    size_t best_index {moves.size()};
+    auto trial = [&](size_t i)
     {
-        const auto first_old_length {tour.length(i)};
-        auto j {tour.next(tour.next(i))};
-        while (j != start)
+        const auto& move {moves[i]};
+        const TrialStart from {start(i)};
+        auto& w {workspace<Move>()};
+        auto& new_tour {w.start_trial(from.tour)};
+        w.tabu.reset(context.tabu_tenure(), removed_edge_count);
+        Operator::for_each_removed_edge(from.tour, move, [&w](primitives::point_id_t a, primitives::point_id_t b)
+        {
+            w.tabu.pin(a, b);
+        });
+        Operator::for_each_endpoint(from.tour, move, [&w](primitives::point_id_t p)
         {
-            const auto current_length {first_old_length + tour.length(j)};
-            if (is_valid_move(tour, i, j, current_length, cost, next_cost))
+            w.repair_queue.push(p);
+            w.touched.push(p);
+        });
+        Operator::apply(new_tour, move);
+        const TabuRules rules(w.tabu, original_length);
+        auto* optima {context.optima()};
+        {
+            const profile::Scope scope(profile::Phase::Repair, Operator::name);
+            restricted_repair<Operator>(new_tour, rules, w.repair_queue, w.touched, context.repair_neighbors());
+            if (optima and optima->contains(new_tour.hash()))
             {
-                swaps.push_back({i, j, cost});
+                return false;
             }
-            j = tour.next(j);
+            solver::local_climb(climb_operators, new_tour, w.touched, rules, context.repair_neighbors());
         }
-    }
-    return swaps;
-}
-
-inline Swap restricted_first_improvement(const TourModifier& tour, const Pair& restriction)
-{
-    constexpr primitives::point_id_t start {0};
-    // first segment cannot be compared with last segment.
-    auto end {tour.prev(start)};
-    const auto first_old_length {tour.length(start)};
-    const Segment first_segment(start, tour.next(start));
-    for (primitives::point_id_t i {tour.next(tour.next(start))}; i != end; i = tour.next(i))
-    {
-        const auto current_length {first_old_length + tour.length(i)};
-        const auto improvement {solver::compute_improvement(tour, start, i, current_length)};
-        if (improvement > 0)
+        if (new_tour.length() >= original_length)
         {
-            const Pair removed(first_segment, Segment(i, tour.next(i)));
-            if (restriction != removed)
+            if (optima)
+            {
+                optima->insert(new_tour.hash());
+            }
+            if (beam)
             {
-                return {start, i, improvement};
+                beam->offer(new_tour, i, from.prefix, w.journal);
             }
+            return false;
         }
-    }
-
-    end = tour.prev(end);
-    for (primitives::point_id_t i {tour.next(start)}; i != end; i = tour.next(i))
-    {
-        const auto first_old_length {tour.length(i)};
-        auto j {tour.next(tour.next(i))};
-        const Segment first_segment(i, tour.next(i));
-        while (j != start)
+        // the local climb leaves distant moves unchecked; settle them only for accepted tours.
+        solver::multi_climb(climb_operators, new_tour);
+        std::lock_guard<std::mutex> lock(mutex);
+        if (i < best_index)
         {
-            const auto current_length {first_old_length + tour.length(j)};
-            const auto improvement {solver::compute_improvement(tour, i, j, current_length)};
-            if (improvement > 0)
+            best_index = i;
+            Workspace<Move>::assign(best_workspace.best, new_tour);
+            best_workspace.best_journal.clear();
+            if (from.prefix)
             {
-                const Pair removed(first_segment, Segment(j, tour.next(j)));
-                if (restriction != removed)
-                {
-                    return {i, j, improvement};
-                }
+                best_workspace.best_journal.append(*from.prefix);
             }
-            j = tour.next(j);
+            best_workspace.best_journal.append(w.journal);
         }
+        return true;
+    };
+    parallel::first_success(moves.size(), context.threads(), trial, [&context] { return context.expired(); });
+    return best_index < moves.size();
+}
+
+// Replaces tour with the best trial of the calling thread's workspace.
+template <typename Move>
+void accept_best(TourModifier& tour, const SearchContext& context)
+{
+    workspace<Move>().accept_best(tour);
+    if (auto* optima {context.optima()})
+    {
+        optima->insert(tour.hash());
+    }
+}
+
+// Returns true and replaces tour with the first improving trial, if there is one.
+// Trials climb with climb_operators.
+template <typename Operator, typename... ClimbOperator>
+bool perturbation_climb(OperatorSet<ClimbOperator...> climb_operators
+    , const std::vector<typename Operator::Move>& moves
+    , TourModifier& tour
+    , const SearchContext& context = {})
+{
+    if (not run_trials<Operator>(climb_operators, moves, [&tour](size_t) { return TrialStart{tour}; }, tour.length(), context))
+    {
+        return false;
     }
-    return {};
+    accept_best<typename Operator::Move>(tour, context);
+    return true;
 }
 
-inline TourModifier perturbation_climb(const std::vector<Swap>& swaps, const TourModifier& tour)
+// Like perturbation_climb, but if no trial improves, the shortest non-improving trial tours (the beam)
+// are perturbed again with moves of the same cost, up to the beam depth of context.
+// All perturbations of a beam level are run as one batch of trials.
+// Returns true and replaces tour with the first improving trial of the shallowest level that has one.
+template <typename Operator, typename... ClimbOperator>
+bool beam_climb(OperatorSet<ClimbOperator...> climb_operators
+    , const std::vector<typename Operator::Move>& moves
+    , TourModifier& tour
+    , primitives::length_t cost
+    , const SearchContext& context)
 {
+    using Move = typename Operator::Move;
+    auto& w {workspace<Move>()};
     const auto original_length {tour.length()};
-    const auto original_points {tour.order()};
-    for (const auto& swap : swaps)
+    auto* beam {&w.beam};
+    auto* next_beam {&w.next_beam};
+    next_beam->reset(context.beam_width());
+    if (run_trials<Operator>(climb_operators, moves, [&tour](size_t) { return TrialStart{tour}; }
+        , original_length, context, next_beam))
+    {
+        accept_best<Move>(tour, context);
+        return true;
+    }
+    for (unsigned depth {2}; depth <= context.beam_depth() and next_beam->size() > 0 and not context.expired(); ++depth)
     {
-        auto new_tour = tour;
-        new_tour.move(swap.a, swap.b);
-        const Pair restriction(Segment(swap.a, swap.b), Segment(tour.next(swap.a), tour.next(swap.b)));
-        while (true)
+        std::swap(beam, next_beam);
+        next_beam->reset(context.beam_width());
+        w.beam_swaps.clear();
+        w.beam_origins.clear();
+        for (size_t b {0}; b < beam->size(); ++b)
         {
-            const auto new_swap {restricted_first_improvement(new_tour, restriction)};
-            if (new_swap.improvement == 0)
+            auto& swaps {w.swaps};
+            primitives::length_t unused_cost {constants::invalid_length};
             {
-                break;
+                const profile::Scope scope(profile::Phase::FindMoves, Operator::name);
+                Operator::find_moves(beam->tour(b), cost, unused_cost, swaps, context.neighbors());
             }
-            new_tour.move(new_swap.a, new_swap.b);
+            w.beam_swaps.insert(w.beam_swaps.end(), swaps.cbegin(), swaps.cend());
+            w.beam_origins.insert(w.beam_origins.end(), swaps.size(), b);
         }
-        solver::multi_climb(new_tour);
-        if (new_tour.length() < original_length)
+        auto start = [beam, &w](size_t i)
         {
-            return new_tour;
+            const auto b {w.beam_origins[i]};
+            return TrialStart{beam->tour(b), &beam->journal(b)};
+        };
+        if (run_trials<Operator>(climb_operators, w.beam_swaps, start, original_length, context, next_beam))
+        {
+            accept_best<Move>(tour, context);
+            return true;
         }
     }
-    return tour;
+    return false;
 }
 
-inline TourModifier perturbation_climb(const TourModifier& tour, primitives::length_t cost, primitives::length_t& next_cost)
+template <typename Operator, typename... ClimbOperator>
+bool perturbation_climb(OperatorSet<ClimbOperator...> climb_operators
+    , TourModifier& tour
+    , primitives::length_t cost
+    , primitives::length_t& next_cost
+    , const SearchContext& context = {})
 {
-    const auto swaps {find_swaps(tour, cost, next_cost)};
-    return perturbation_climb(swaps, tour);
+    auto& moves {workspace<typename Operator::Move>().swaps};
+    {
+        const profile::Scope scope(profile::Phase::FindMoves, Operator::name);
+        Operator::find_moves(tour, cost, next_cost, moves, context.neighbors());
+    }
+    if (context.beam())
+    {
+        return beam_climb<Operator>(climb_operators, moves, tour, cost, context);
+    }
+    return perturbation_climb<Operator>(climb_operators, moves, tour, context);
 }
 
-inline TourModifier perturbation_climb(const TourModifier& tour)
+// Returns true if tour was improved. Tries no cost level once time runs out or the tour is within the target gap.
+template <typename Operator, typename... ClimbOperator>
+bool perturbation_climb(OperatorSet<ClimbOperator...> climb_operators
+    , TourModifier& tour
+    , const SearchContext& context = {})
 {
-    const auto original_length {tour.length()};
     primitives::length_t current_cost {0};
-    while (true)
+    while (not context.expired() and not context.target_reached(tour.length()))
     {
-        std::cout << "trying perturbation cost: " << current_cost << std::endl;
+        context.report(Progress::Event::PerturbationCost, tour.length(), Operator::name, current_cost);
         primitives::length_t next_cost {constants::invalid_length};
-        const auto new_tour {perturbation_climb(tour, current_cost, next_cost)};
-        if (new_tour.length() < original_length)
+        if (perturbation_climb<Operator>(climb_operators, tour, current_cost, next_cost, context))
         {
-            return new_tour;
+            return true;
         }
         if (next_cost == constants::invalid_length)
         {
@@ -159,8 +262,7 @@ inline TourModifier perturbation_climb(const TourModifier& tour)
         }
         current_cost = next_cost;
     }
-    std::cout << "No more perturbations left to try." << std::endl;
-    return tour;
+    return false;
 }
 
 } // namespace lateral
@@ -0,0 +1,277 @@
+#pragma once
+
+// Held-Karp lower bound on the optimal tour length.
+// A 1-tree (a spanning tree of all points but one, plus the two shortest edges to that one)
+// is no longer than any tour. This still holds after adding a penalty pi[i] to every edge at point i
+// and subtracting 2 * sum(pi), as every point of a tour has exactly two edges.
+// Subgradient optimization raises the penalties of points with more than two 1-tree edges and lowers
+// those with fewer, pushing the 1-tree towards a tour and the bound towards the optimal length.
+// The iterations use a sparse candidate graph (nearest neighbors plus the edges of a tour) to scale;
+// the final bound is computed over all point pairs, as a sparse 1-tree can be longer than the minimum.
+// That takes O(n^2) time, so larger instances (see max_points) get no bound.
+
+#include "DistanceMatrix.h"
+#include "Instance.h"
+#include "PointGrid.h"
+#include "primitives.h"
+
+#include <algorithm> // nth_element, sort
+#include <cmath> // ceil
+#include <limits>
+#include <numeric> // iota
+#include <vector>
+
+namespace lower_bound {
+
+// largest instance with a bound: the final dense 1-tree takes about a second at this size.
+constexpr primitives::point_id_t max_points {10000};
+
+struct Edge
+{
+    primitives::point_id_t a {0};
+    primitives::point_id_t b {0};
+    primitives::length_t length {0};
+};
+
+inline primitives::point_id_t find_root(std::vector<primitives::point_id_t>& parent, primitives::point_id_t i)
+{
+    while (parent[i] != i)
+    {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+// Edges to the neighbor_count nearest neighbors of every point, and the edges of tour,
+// which keep the candidate graph connected.
+inline std::vector<Edge> candidate_edges(const Instance& instance
+    , const std::vector<primitives::point_id_t>& tour
+    , primitives::point_id_t neighbor_count)
+{
+    const primitives::point_id_t n = tour.size();
+    std::vector<Edge> edges;
+    auto add = [&edges, &instance](primitives::point_id_t a, primitives::point_id_t b)
+    {
+        edges.push_back({std::min(a, b), std::max(a, b), instance.length(a, b)});
+    };
+    std::vector<primitives::point_id_t> neighbors;
+    if (const auto* matrix {instance.matrix().get()})
+    {
+        for (primitives::point_id_t i {0}; i < n; ++i)
+        {
+            neighbors.clear();
+            for (primitives::point_id_t j {0}; j < n; ++j)
+            {
+                if (j != i)
+                {
+                    neighbors.push_back(j);
+                }
+            }
+            const auto k {std::min<size_t>(neighbor_count, neighbors.size())};
+            std::nth_element(neighbors.begin(), neighbors.begin() + k, neighbors.end()
+                , [matrix, i](auto a, auto b) { return matrix->length(i, a) < matrix->length(i, b); });
+            for (size_t j {0}; j < k; ++j)
+            {
+                add(i, neighbors[j]);
+            }
+        }
+    }
+    else
+    {
+        const PointGrid grid(instance.x(), instance.y());
+        for (primitives::point_id_t i {0}; i < n; ++i)
+        {
+            grid.nearest(i, neighbor_count, neighbors);
+            for (auto j : neighbors)
+            {
+                add(i, j);
+            }
+        }
+    }
+    for (primitives::point_id_t i {0}; i < n; ++i)
+    {
+        add(tour[i], tour[(i + 1) % n]);
+    }
+    std::sort(edges.begin(), edges.end(), [](const Edge& e, const Edge& f)
+    {
+        return e.a < f.a or (e.a == f.a and e.b < f.b);
+    });
+    edges.erase(std::unique(edges.begin(), edges.end(), [](const Edge& e, const Edge& f)
+    {
+        return e.a == f.a and e.b == f.b;
+    }), edges.end());
+    return edges;
+}
+
+// Penalized length of the minimum 1-tree of the candidate edges, with point 0 as the special point.
+// Fills degree with the 1-tree degree of every point.
+inline double sparse_one_tree(const std::vector<Edge>& edges
+    , const std::vector<double>& pi
+    , std::vector<primitives::point_id_t>& order
+    , std::vector<double>& weight
+    , std::vector<primitives::point_id_t>& parent
+    , std::vector<int>& degree)
+{
+    const primitives::point_id_t n = pi.size();
+    for (size_t e {0}; e < edges.size(); ++e)
+    {
+        weight[e] = edges[e].length + pi[edges[e].a] + pi[edges[e].b];
+    }
+    std::sort(order.begin(), order.end(), [&weight](auto e, auto f) { return weight[e] < weight[f]; });
+    std::iota(parent.begin(), parent.end(), 0);
+    degree.assign(n, 0);
+    double total {0};
+    int special_edges {0};
+    for (auto e : order)
+    {
+        const auto& edge {edges[e]};
+        if (edge.a == 0)
+        {
+            // the two shortest edges to the special point.
+            if (special_edges == 2)
+            {
+                continue;
+            }
+            ++special_edges;
+        }
+        else
+        {
+            const auto a {find_root(parent, edge.a)};
+            const auto b {find_root(parent, edge.b)};
+            if (a == b)
+            {
+                continue;
+            }
+            parent[a] = b;
+        }
+        total += weight[e];
+        ++degree[edge.a];
+        ++degree[edge.b];
+    }
+    for (auto p : pi)
+    {
+        total -= 2 * p;
+    }
+    return total;
+}
+
+// Penalized length of the minimum 1-tree over all point pairs (Prim's algorithm, O(n^2) time and O(n) space).
+inline double dense_one_tree(const Instance& instance, const std::vector<double>& pi)
+{
+    const primitives::point_id_t n = pi.size();
+    auto weight = [&instance, &pi](primitives::point_id_t a, primitives::point_id_t b)
+    {
+        return instance.length(a, b) + pi[a] + pi[b];
+    };
+    constexpr auto infinity {std::numeric_limits<double>::max()};
+    std::vector<double> key(n, infinity);
+    std::vector<bool> in_tree(n, false);
+    double total {0};
+    // tree over points 1 to n - 1.
+    key[1] = 0;
+    for (primitives::point_id_t added {1}; added < n; ++added)
+    {
+        primitives::point_id_t next {0};
+        for (primitives::point_id_t i {1}; i < n; ++i)
+        {
+            if (not in_tree[i] and (next == 0 or key[i] < key[next]))
+            {
+                next = i;
+            }
+        }
+        in_tree[next] = true;
+        total += key[next];
+        for (primitives::point_id_t i {1}; i < n; ++i)
+        {
+            if (not in_tree[i])
+            {
+                key[i] = std::min(key[i], weight(next, i));
+            }
+        }
+    }
+    double first {infinity};
+    double second {infinity};
+    for (primitives::point_id_t i {1}; i < n; ++i)
+    {
+        const auto w {weight(0, i)};
+        if (w < first)
+        {
+            second = first;
+            first = w;
+        }
+        else if (w < second)
+        {
+            second = w;
+        }
+    }
+    total += first + second;
+    for (auto p : pi)
+    {
+        total -= 2 * p;
+    }
+    return total;
+}
+
+// Returns a lower bound on the optimal tour length; tour (of length tour_length) serves as the upper bound
+// that scales the subgradient steps. Returns 0 (no bound) for fewer than 3 or more than max_points points.
+inline primitives::length_t held_karp(const Instance& instance
+    , const std::vector<primitives::point_id_t>& tour
+    , primitives::length_t tour_length
+    , primitives::point_id_t neighbor_count = 10
+    , int max_iterations = 500)
+{
+    const primitives::point_id_t n = tour.size();
+    if (n < 3 or n > max_points)
+    {
+        return 0;
+    }
+    const auto edges {candidate_edges(instance, tour, neighbor_count)};
+    std::vector<primitives::point_id_t> order(edges.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::vector<double> weight(edges.size());
+    std::vector<primitives::point_id_t> parent(n);
+    std::vector<int> degree(n);
+
+    std::vector<double> pi(n, 0);
+    auto best_pi {pi};
+    double best {-std::numeric_limits<double>::max()};
+    // step scale, halved whenever the bound has not improved for a period of iterations.
+    double lambda {2};
+    constexpr int period {20};
+    int stalled {0};
+    for (int iteration {0}; iteration < max_iterations and lambda > 1e-3; ++iteration)
+    {
+        const auto bound {sparse_one_tree(edges, pi, order, weight, parent, degree)};
+        if (bound > best)
+        {
+            best = bound;
+            best_pi = pi;
+            stalled = 0;
+        }
+        else if (++stalled == period)
+        {
+            lambda /= 2;
+            stalled = 0;
+        }
+        double norm {0};
+        for (auto d : degree)
+        {
+            norm += (d - 2) * (d - 2);
+        }
+        if (norm == 0 or bound >= tour_length)
+        {
+            break; // the 1-tree is a tour, or the bound met the upper bound.
+        }
+        const auto step {lambda * (tour_length - bound) / norm};
+        for (primitives::point_id_t i {0}; i < n; ++i)
+        {
+            pi[i] += step * (degree[i] - 2);
+        }
+    }
+    const auto bound {dense_one_tree(instance, best_pi)};
+    // lengths are integers, so the bound rounds up; the tolerance absorbs floating-point error.
+    return bound > 0 ? static_cast<primitives::length_t>(std::ceil(bound - 1e-6)) : 0;
+}
+
+} // namespace lower_bound
@@ -0,0 +1,192 @@
+#pragma once
+
+// Multi-level solving: points are repeatedly merged with their nearest neighbors into super-nodes,
+// the coarsest point set is solved, and the tour is then refined level by level.
+// Coarse levels settle the overall tour structure cheaply, leaving mostly local cleanup to the finer levels.
+
+#include "Instance.h"
+#include "NeighborLists.h"
+#include "PointQueue.h"
+#include "SearchContext.h"
+#include "TourModifier.h"
+#include "constants.h"
+#include "perturbation.h"
+#include "primitives.h"
+#include "solver.h"
+
+#include <algorithm> // max, swap
+#include <array>
+#include <limits>
+#include <memory> // shared_ptr
+#include <vector>
+
+namespace multilevel {
+
+struct Level
+{
+    // coordinates of each super-node, at the weighted centroid of the points it stands for.
+    std::vector<primitives::space_t> x;
+    std::vector<primitives::space_t> y;
+    std::vector<primitives::point_id_t> weight; // number of original points in each super-node.
+    // the one or two points of the finer level merged into each super-node (second is invalid if unmatched).
+    std::vector<std::array<primitives::point_id_t, 2>> children;
+};
+
+// neighbors per point, for matching and refining.
+constexpr primitives::point_id_t neighbor_count {10};
+
+// Matches each point with its nearest unmatched neighbor, if it has one (else it stays alone), in O(nk).
+inline Level coarsen(const Instance& instance
+    , const NeighborLists& neighbors
+    , const std::vector<primitives::point_id_t>& weight)
+{
+    const auto& x {instance.x()};
+    const auto& y {instance.y()};
+    Level level;
+    std::vector<bool> matched(x.size(), false);
+    for (primitives::point_id_t i {0}; i < x.size(); ++i)
+    {
+        if (matched[i])
+        {
+            continue;
+        }
+        matched[i] = true;
+        primitives::point_id_t j {constants::invalid_point};
+        const auto* near {neighbors.of(i)};
+        for (primitives::point_id_t k {0}; k < neighbors.count() and j == constants::invalid_point; ++k)
+        {
+            if (not matched[near[k]])
+            {
+                j = near[k];
+            }
+        }
+        if (j == constants::invalid_point)
+        {
+            level.x.push_back(x[i]);
+            level.y.push_back(y[i]);
+            level.weight.push_back(weight[i]);
+            level.children.push_back({i, constants::invalid_point});
+            continue;
+        }
+        matched[j] = true;
+        const auto total {weight[i] + weight[j]};
+        level.x.push_back((x[i] * weight[i] + x[j] * weight[j]) / total);
+        level.y.push_back((y[i] * weight[i] + y[j] * weight[j]) / total);
+        level.weight.push_back(total);
+        level.children.push_back({i, j});
+    }
+    return level;
+}
+
+// Expands each super-node of the coarse tour into its children,
+// putting first the child closer to the previously placed point.
+inline std::vector<primitives::point_id_t> uncoarsen(const std::vector<primitives::point_id_t>& coarse_tour
+    , const Level& level
+    , const std::vector<primitives::space_t>& x
+    , const std::vector<primitives::space_t>& y)
+{
+    auto squared_distance = [&x, &y](primitives::point_id_t a, primitives::point_id_t b)
+    {
+        const auto dx {x[a] - x[b]};
+        const auto dy {y[a] - y[b]};
+        return dx * dx + dy * dy;
+    };
+    std::vector<primitives::point_id_t> tour;
+    for (auto c : coarse_tour)
+    {
+        auto children {level.children[c]};
+        if (children[1] == constants::invalid_point)
+        {
+            tour.push_back(children[0]);
+            continue;
+        }
+        if (not tour.empty()
+            and squared_distance(tour.back(), children[1]) < squared_distance(tour.back(), children[0]))
+        {
+            std::swap(children[0], children[1]);
+        }
+        tour.push_back(children[0]);
+        tour.push_back(children[1]);
+    }
+    return tour;
+}
+
+// Climbs from a tour that is already good almost everywhere:
+// a local climb seeded with every point settles the local defects without full scans,
+// searching only moves between neighbors (O(k) per point). The result is a local optimum among those moves;
+// the caller's climb confirms a full one at the finest level.
+inline void refine(TourModifier& tour, const NeighborLists& neighbors, const SearchContext& context)
+{
+    PointQueue queue(tour.size());
+    for (primitives::point_id_t i {0}; i < tour.size(); ++i)
+    {
+        queue.push(i);
+    }
+    solver::local_climb(tour, queue, context.operators(), &neighbors);
+}
+
+// Returns a tour of the original points, climbed at every level.
+// Coarsening stops at coarsest_size points or when matching no longer shrinks the point set.
+// If perturb is true and context has a time budget, the perturbation phase also runs on the coarse levels,
+// which share at most half of the remaining time evenly; the finest level is left to the caller.
+// Coarse levels are searched silently (see SearchContext::silent), as their tours are not tours of the instance.
+inline std::vector<primitives::point_id_t> solve(const std::shared_ptr<const Instance>& instance
+    , primitives::point_id_t coarsest_size
+    , bool perturb
+    , const SearchContext& context = {})
+{
+    constexpr primitives::point_id_t min_coarsest_size {8}; // climbs need a handful of points.
+    coarsest_size = std::max(coarsest_size, min_coarsest_size);
+    std::vector<Level> levels;
+    // instance and neighbor lists of each level, the original points first.
+    std::vector<std::shared_ptr<const Instance>> instances {instance};
+    std::vector<NeighborLists> neighbors;
+    const std::vector<primitives::point_id_t> weight(instance->size(), 1);
+    while (instances.back()->size() > coarsest_size)
+    {
+        const auto k {levels.size()};
+        neighbors.emplace_back().build(*instances[k], neighbor_count);
+        auto level {coarsen(*instances[k], neighbors[k], k == 0 ? weight : levels[k - 1].weight)};
+        if (10 * level.x.size() > 9 * instances[k]->size())
+        {
+            break;
+        }
+        instances.push_back(std::make_shared<const Instance>(level.x, level.y));
+        levels.push_back(std::move(level));
+    }
+
+    // coarsest level.
+    auto k {levels.size()};
+    std::vector<primitives::point_id_t> tour;
+    for (primitives::point_id_t i {0}; i < instances[k]->size(); ++i)
+    {
+        tour.push_back(i);
+    }
+    while (true)
+    {
+        TourModifier tour_modifier(tour, instances[k]);
+        if (k == levels.size())
+        {
+            solver::multi_climb(tour_modifier, context.operators());
+        }
+        else
+        {
+            refine(tour_modifier, neighbors[k], context);
+        }
+        // without a budget, perturbing every coarse level to completion would cost more than the finest level.
+        const auto remaining {context.remaining()};
+        if (k > 0 and perturb and remaining < std::numeric_limits<double>::infinity() and not context.expired())
+        {
+            perturbation::climb(tour_modifier, context.silent().limited(remaining / (2 * k)));
+        }
+        tour = tour_modifier.order();
+        if (k == 0)
+        {
+            return tour;
+        }
+        --k;
+        tour = uncoarsen(tour, levels[k], instances[k]->x(), instances[k]->y());
+    }
+}
+
+} // namespace multilevel
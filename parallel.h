@@ -0,0 +1,158 @@
+#pragma once
+
+// Helpers for running independent trials on multiple threads.
+// The threads are kept in a pool between calls (see Pool), so that calls made for every cost level
+// neither start threads nor rebuild the thread-local storage of the workers (see Workspace.h).
+
+#include <algorithm> // max, min
+#include <atomic>
+#include <condition_variable>
+#include <cstddef> // size_t
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace parallel {
+
+// Worker threads that wait between calls of run.
+class Pool
+{
+public:
+    Pool() = default;
+    Pool(const Pool&) = delete;
+    Pool& operator=(const Pool&) = delete;
+    ~Pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_start.notify_all();
+        for (auto& t : m_threads)
+        {
+            t.join();
+        }
+    }
+
+    // Calls work() on the calling thread and on thread_count - 1 workers, and returns once all calls have returned.
+    // Workers are started by the first call that needs them.
+    template <typename Work>
+    void run(unsigned thread_count, const Work& work)
+    {
+        const unsigned worker_count {std::max(thread_count, 1u) - 1};
+        if (worker_count == 0)
+        {
+            work();
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            while (m_threads.size() < worker_count)
+            {
+                const unsigned index = m_threads.size();
+                m_threads.emplace_back([this, index, generation = m_generation] { serve(index, generation); });
+            }
+            m_work = &work;
+            m_call = [](const void* w) { (*static_cast<const Work*>(w))(); };
+            m_worker_count = worker_count;
+            m_pending = worker_count;
+            ++m_generation;
+        }
+        m_start.notify_all();
+        work();
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this] { return m_pending == 0; });
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_start;
+    std::condition_variable m_done;
+    std::vector<std::thread> m_threads;
+    bool m_stop {false};
+    size_t m_generation {0}; // number of calls of run with workers.
+    unsigned m_worker_count {0}; // workers taking part in the current call.
+    unsigned m_pending {0}; // of those, the ones still working.
+    const void* m_work {nullptr};
+    void (*m_call)(const void*) {nullptr};
+
+    void serve(unsigned index, size_t generation)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true)
+        {
+            m_start.wait(lock, [this, generation] { return m_stop or m_generation != generation; });
+            if (m_stop)
+            {
+                return;
+            }
+            generation = m_generation;
+            if (index >= m_worker_count)
+            {
+                continue;
+            }
+            const auto call {m_call};
+            const auto* work {m_work};
+            lock.unlock();
+            call(work);
+            lock.lock();
+            if (--m_pending == 0)
+            {
+                m_done.notify_one();
+            }
+        }
+    }
+};
+
+// The pool of the calling thread; each thread has its own, so that concurrent callers (e.g. batch solves) do not wait
+// for each other.
+inline Pool& pool()
+{
+    thread_local Pool p;
+    return p;
+}
+
+// Runs trial(i) for i in [0, count) until one returns true, and returns the lowest such i
+// (count if none). Trials beyond a known success are skipped, so the result is the same for any thread count.
+// stop() is checked before each trial; once it returns true, no more trials are started.
+template <typename Trial, typename Stop>
+size_t first_success(size_t count, unsigned thread_count, const Trial& trial, const Stop& stop)
+{
+    std::atomic<size_t> next {0};
+    std::atomic<size_t> success {count};
+    auto work = [&]()
+    {
+        while (true)
+        {
+            const auto i {next++};
+            if (i >= count or i > success or stop())
+            {
+                return;
+            }
+            if (trial(i))
+            {
+                auto current {success.load()};
+                while (i < current and not success.compare_exchange_weak(current, i)) {}
+            }
+        }
+    };
+    pool().run(std::min<size_t>(std::max(thread_count, 1u), count), work);
+    return success;
+}
+
+// Runs task(i) for all i in [0, count).
+template <typename Task>
+void for_each(size_t count, unsigned thread_count, const Task& task)
+{
+    std::atomic<size_t> next {0};
+    auto work = [&]()
+    {
+        for (auto i {next++}; i < count; i = next++)
+        {
+            task(i);
+        }
+    };
+    pool().run(std::min<size_t>(std::max(thread_count, 1u), count), work);
+}
+
+} // namespace parallel
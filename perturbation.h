@@ -0,0 +1,66 @@
+#pragma once
+
+// Perturbation hill-climbing: alternates the lateral phases of all enabled operators.
+
+#include "OperatorSet.h"
+#include "SearchContext.h"
+#include "TourModifier.h"
+#include "lateral.h"
+
+namespace perturbation {
+
+// Runs the lateral phase of Operator, reporting an improvement. Returns true if the tour improved.
+template <typename Operator, typename ClimbOperators>
+bool phase(ClimbOperators climb_operators, TourModifier& tour, const SearchContext& context)
+{
+    if (not lateral::perturbation_climb<Operator>(climb_operators, tour, context))
+    {
+        return false;
+    }
+    context.report(Progress::Event::Improvement, tour.length(), Operator::name);
+    context.snapshot(tour);
+    return true;
+}
+
+// Runs the phases of the phase operators in order until none improves the tour, time runs out,
+// or the target gap is reached. Returns true if the tour improved.
+template <typename... PhaseOperator, typename ClimbOperators>
+bool climb(OperatorSet<PhaseOperator...>
+    , [[maybe_unused]] ClimbOperators climb_operators
+    , TourModifier& tour
+    , const SearchContext& context = {})
+{
+    auto done = [&tour, &context] { return context.expired() or context.target_reached(tour.length()); };
+    bool improved {false};
+    bool improving {true};
+    while (improving and not done())
+    {
+        improving = false;
+        // no phase starts after one that reaches the target (or runs out of time).
+        static_cast<void>(((improving |= phase<PhaseOperator>(climb_operators, tour, context), done()) or ...));
+        improved |= improving;
+    }
+    return improved;
+}
+
+// v-opt phases run before 2-opt phases; other sets keep their order.
+inline auto phase_order(OperatorSet<twoopt::Operator, vopt::Operator>)
+{
+    return OperatorSet<vopt::Operator, twoopt::Operator>{};
+}
+
+template <typename OperatorSetType>
+OperatorSetType phase_order(OperatorSetType set)
+{
+    return set;
+}
+
+inline bool climb(TourModifier& tour, const SearchContext& context = {})
+{
+    return with_operators(context.operators(), [&tour, &context](auto set)
+    {
+        return climb(phase_order(set), set, tour, context);
+    });
+}
+
+} // namespace perturbation
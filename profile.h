@@ -0,0 +1,240 @@
+#pragma once
+
+// Optional profile of the phases of a search: calls, wall time and hardware counters (see PerfCounters) per phase
+// and operator, summed over all threads. Time spent in a nested phase counts only for the nested phase.
+// Disabled by default, in which case a phase scope costs one relaxed atomic load.
+
+#include "PerfCounters.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring> // strcmp
+#include <iomanip> // setw
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace profile {
+
+enum class Phase
+{
+    Climb, // solver::hill_climb and batch_climb.
+    FindMoves, // lateral moves of a cost level (find_moves of the operators).
+    Repair // repair and local climb of a perturbation trial.
+};
+
+inline const char* phase_name(Phase phase)
+{
+    switch (phase)
+    {
+        case Phase::Climb:
+            return "climb";
+        case Phase::FindMoves:
+            return "find moves";
+        case Phase::Repair:
+            return "trial repair";
+        default:
+            return "";
+    }
+}
+
+struct Row
+{
+    Phase phase {Phase::Climb};
+    const char* name {""}; // of the operator.
+    uint64_t calls {0};
+    double seconds {0};
+    PerfCounters::Sample counters {};
+
+    void add(const Row& other)
+    {
+        calls += other.calls;
+        seconds += other.seconds;
+        for (int event {0}; event < PerfCounters::EventCount; ++event)
+        {
+            counters[event] += other.counters[event];
+        }
+    }
+};
+
+inline std::atomic<bool>& enabled_flag()
+{
+    static std::atomic<bool> enabled {false};
+    return enabled;
+}
+
+inline void enable() { enabled_flag().store(true, std::memory_order_relaxed); }
+inline bool enabled() { return enabled_flag().load(std::memory_order_relaxed); }
+
+inline Row& find_row(std::vector<Row>& rows, Phase phase, const char* name)
+{
+    for (auto& row : rows)
+    {
+        if (row.phase == phase and std::strcmp(row.name, name) == 0)
+        {
+            return row;
+        }
+    }
+    rows.push_back({phase, name});
+    return rows.back();
+}
+
+// Rows of the threads that have finished (and of report calls).
+struct MergedRows
+{
+    std::mutex mutex;
+    std::vector<Row> rows;
+};
+
+inline MergedRows& merged_rows()
+{
+    static MergedRows merged;
+    return merged;
+}
+
+inline void merge(std::vector<Row>& rows)
+{
+    auto& merged {merged_rows()};
+    std::lock_guard<std::mutex> lock(merged.mutex);
+    for (const auto& row : rows)
+    {
+        find_row(merged.rows, row.phase, row.name).add(row);
+    }
+    rows.clear();
+}
+
+class Scope;
+
+// Counters and rows of one thread; rows are merged when the thread ends.
+struct ThreadProfile
+{
+    PerfCounters counters;
+    std::vector<Row> rows;
+    Scope* current {nullptr};
+
+    ~ThreadProfile() { merge(rows); }
+};
+
+inline ThreadProfile& thread_profile()
+{
+    thread_local ThreadProfile profile;
+    return profile;
+}
+
+// Counts the lifetime of the scope (less that of nested scopes) for the phase of the named operator.
+class Scope
+{
+    using clock = std::chrono::steady_clock;
+public:
+    Scope(Phase phase, const char* name) : m_active(enabled())
+    {
+        if (not m_active)
+        {
+            return;
+        }
+        auto& thread {thread_profile()};
+        m_phase = phase;
+        m_name = name;
+        m_parent = thread.current;
+        thread.current = this;
+        start(thread);
+        if (m_parent)
+        {
+            m_parent->charge(thread, m_start, m_start_counters, false);
+        }
+    }
+
+    ~Scope()
+    {
+        if (not m_active)
+        {
+            return;
+        }
+        auto& thread {thread_profile()};
+        const auto now {clock::now()};
+        const auto counters {thread.counters.read()};
+        charge(thread, now, counters, true);
+        thread.current = m_parent;
+        if (m_parent)
+        {
+            m_parent->m_start = now;
+            m_parent->m_start_counters = counters;
+        }
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    bool m_active {false};
+    Phase m_phase {Phase::Climb};
+    const char* m_name {""};
+    Scope* m_parent {nullptr};
+    clock::time_point m_start;
+    PerfCounters::Sample m_start_counters {};
+
+    void start(ThreadProfile& thread)
+    {
+        m_start = clock::now();
+        m_start_counters = thread.counters.read();
+    }
+
+    void charge(ThreadProfile& thread, clock::time_point now, const PerfCounters::Sample& counters, bool call)
+    {
+        auto& row {find_row(thread.rows, m_phase, m_name)};
+        row.calls += call ? 1 : 0;
+        row.seconds += std::chrono::duration<double>(now - m_start).count();
+        for (int event {0}; event < PerfCounters::EventCount; ++event)
+        {
+            row.counters[event] += counters[event] - m_start_counters[event];
+        }
+    }
+};
+
+// Writes the rows of all finished threads and of the calling thread.
+inline void report(std::ostream& output)
+{
+    merge(thread_profile().rows);
+    auto& merged {merged_rows()};
+    std::lock_guard<std::mutex> lock(merged.mutex);
+    const auto& rows {merged.rows};
+    const auto& counters {thread_profile().counters};
+    output << std::left << std::setw(22) << "phase" << std::right << std::setw(12) << "calls" << std::setw(12) << "seconds";
+    for (int event {0}; event < PerfCounters::EventCount; ++event)
+    {
+        output << std::setw(16) << PerfCounters::name(static_cast<PerfCounters::Event>(event));
+    }
+    output << std::setw(8) << "IPC" << "\n";
+    for (const auto& row : rows)
+    {
+        output << std::left << std::setw(22) << (std::string(row.name) + " " + phase_name(row.phase))
+            << std::right << std::setw(12) << row.calls << std::setw(12) << std::fixed << std::setprecision(3) << row.seconds;
+        for (int event {0}; event < PerfCounters::EventCount; ++event)
+        {
+            if (counters.available(static_cast<PerfCounters::Event>(event)))
+            {
+                output << std::setw(16) << row.counters[event];
+            }
+            else
+            {
+                output << std::setw(16) << "-";
+            }
+        }
+        const auto cycles {row.counters[PerfCounters::Cycles]};
+        output << std::setw(8) << std::setprecision(2);
+        if (cycles > 0)
+        {
+            output << static_cast<double>(row.counters[PerfCounters::Instructions]) / cycles;
+        }
+        else
+        {
+            output << "-";
+        }
+        output << "\n";
+    }
+    output << std::defaultfloat;
+}
+
+} // namespace profile
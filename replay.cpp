@@ -0,0 +1,52 @@
+#include "MoveJournal.h"
+#include "TourModifier.h"
+#include "fileio.h"
+
+#include <chrono>
+#include <iostream>
+#include <memory> // shared_ptr
+#include <vector>
+
+// Re-applies the moves of a journal written by 2-opt.out --journal, e.g. to reproduce or profile a run.
+int main(int argc, const char** argv)
+{
+    if (argc < 3)
+    {
+        std::cout << "Arguments: point_set_file_path journal_file_path optional_output_tour_file_path" << std::endl;
+        return 0;
+    }
+    std::vector<primitives::space_t> x, y;
+    std::shared_ptr<const DistanceMatrix> matrix;
+    fileio::read_instance(argv[1], x, y, matrix);
+    const auto journal {MoveJournal::read(argv[2])};
+    if (journal.initial_tour().size() != x.size())
+    {
+        std::cout << "error: journal has " << journal.initial_tour().size()
+            << " points but the point set has " << x.size() << "." << std::endl;
+        return 1;
+    }
+    TourModifier tour(journal.initial_tour(), x, y, matrix);
+    std::cout << "Initial tour length: " << tour.length() << std::endl;
+
+    const auto start {std::chrono::steady_clock::now()};
+    for (const auto& entry : journal.entries())
+    {
+        switch (entry.kind)
+        {
+            case MoveJournal::Kind::Move:
+                tour.move(entry.a, entry.b);
+                break;
+            case MoveJournal::Kind::VMove:
+                tour.vmove(entry.a, entry.b);
+                break;
+        }
+    }
+    const std::chrono::duration<double> seconds {std::chrono::steady_clock::now() - start};
+    std::cout << "Replayed " << journal.entries().size() << " moves in " << seconds.count() << " s." << std::endl;
+    std::cout << "Final tour length: " << tour.length() << std::endl;
+    if (argc > 3)
+    {
+        fileio::write_ordered_points(tour.order(), argv[3]);
+    }
+    return 0;
+}
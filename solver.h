@@ -1,76 +1,28 @@
 #pragma once
 
-#include "Swap.h"
+// Climbs: apply improving moves of a set of operators (see OperatorSet.h) until there are none.
+
+#include "NeighborLists.h"
+#include "OperatorSet.h"
+#include "Operators.h"
+#include "PointQueue.h"
 #include "TourModifier.h"
 #include "constants.h"
 #include "primitives.h"
-#include "vopt/vopt.h"
+#include "profile.h"
 
+#include <cstdlib> // abort
+#include <iostream>
 #include <vector>
 
 namespace solver {
 
-inline primitives::length_t compute_improvement(const TourModifier& tour
-    , primitives::point_id_t i
-    , primitives::point_id_t j
-    , primitives::length_t current_length)
-{
-    auto new_length {tour.length_map().compute_length(i, j)};
-    if (new_length > current_length)
-    {
-        return 0;
-    }
-    new_length += tour.length_map().compute_length(tour.next(i), tour.next(j));
-    if (new_length > current_length)
-    {
-        return 0;
-    }
-    if (new_length < current_length)
-    {
-        return current_length - new_length;
-    }
-    return 0;
-}
-
-inline Swap first_improvement(const TourModifier& tour)
-{
-    constexpr primitives::point_id_t start {0};
-    // first segment cannot be compared with last segment.
-    auto end {tour.prev(start)};
-    const auto first_old_length {tour.length(start)};
-    for (primitives::point_id_t i {tour.next(tour.next(start))}; i != end; i = tour.next(i))
-    {
-        const auto current_length {first_old_length + tour.length(i)};
-        const auto improvement {compute_improvement(tour, start, i, current_length)};
-        if (improvement > 0)
-        {
-            return {start, i, improvement};
-        }
-    }
-
-    end = tour.prev(end);
-    for (primitives::point_id_t i {tour.next(start)}; i != end; i = tour.next(i))
-    {
-        const auto first_old_length {tour.length(i)};
-        auto j {tour.next(tour.next(i))};
-        while (j != start)
-        {
-            const auto current_length {first_old_length + tour.length(j)};
-            const auto improvement {compute_improvement(tour, i, j, current_length)};
-            if (improvement > 0)
-            {
-                return {i, j, improvement};
-            }
-            j = tour.next(j);
-        }
-    }
-    return {};
-}
-
-inline bool hill_climb(TourModifier& tour)
+template <typename Operator>
+bool hill_climb(TourModifier& tour)
 {
+    const profile::Scope scope(profile::Phase::Climb, Operator::name);
     bool improved {false};
-    auto move {first_improvement(tour)};
+    auto move {Operator::first_improvement(tour)};
     if (move.improvement > 0)
     {
         improved = true;
@@ -78,7 +30,7 @@ inline bool hill_climb(TourModifier& tour)
     int iteration{1};
     while (move.improvement > 0)
     {
-        tour.move(move.a, move.b);
+        Operator::apply(tour, move);
         if (constants::verbose)
         {
             auto length {tour.length()};
@@ -86,7 +38,7 @@ inline bool hill_climb(TourModifier& tour)
                 << " tour length: " << length
                 << " (step improvement: " << move.improvement << ")\n";
         }
-        move = first_improvement(tour);
+        move = Operator::first_improvement(tour);
         if (move.improvement > 0)
         {
             improved = true;
@@ -96,14 +48,120 @@ inline bool hill_climb(TourModifier& tour)
     return improved;
 }
 
-inline void multi_climb(TourModifier& tour)
+// Like hill_climb, but each scan collects all the improving moves it can apply together and applies them as a batch,
+// with a single update of the tour orientation (see TourModifier::begin_batch) instead of one per move.
+// Pays off when scans pass many improving moves, as from an initial tour.
+template <typename Operator>
+bool batch_climb(TourModifier& tour)
+{
+    const profile::Scope scope(profile::Phase::Climb, Operator::name);
+    if (tour.journal())
+    {
+        return hill_climb<Operator>(tour);
+    }
+    bool improved {false};
+    std::vector<typename Operator::Move> moves;
+    Operator::batch_improvements(tour, moves);
+    while (not moves.empty())
+    {
+        improved = true;
+        const auto length {tour.length()};
+        primitives::length_t improvement {0};
+        tour.begin_batch();
+        for (const auto& move : moves)
+        {
+            Operator::apply(tour, move);
+            improvement += move.improvement;
+        }
+        tour.end_batch();
+        if (length - tour.length() != improvement)
+        {
+            std::cout << __func__ << ": error: batch of " << moves.size() << " " << Operator::name
+                << " moves improved by " << length - tour.length() << " instead of " << improvement << "." << std::endl;
+            std::abort();
+        }
+        if (constants::verbose)
+        {
+            std::cout << "Batch of " << moves.size() << " moves, tour length: " << tour.length()
+                << " (step improvement: " << improvement << ")\n";
+        }
+        Operator::batch_improvements(tour, moves);
+    }
+    return improved;
+}
+
+// Rules of a climb: which improving moves it may apply, and how it applies them.
+// The default rules allow every move (see TabuRules for the rules of perturbation trials).
+struct Unrestricted
+{
+    template <typename Operator>
+    bool allows(const TourModifier&, const typename Operator::Move&) const { return true; }
+
+    template <typename Operator>
+    void apply(TourModifier& tour, const typename Operator::Move& move) const { Operator::apply(tour, move); }
+};
+
+// Returns the first improving move around point i that rules allow
+// (given neighbor lists, only among moves adding a segment between i and one of its neighbors).
+template <typename Operator, typename Rules>
+typename Operator::Move point_improvement(const TourModifier& tour
+    , primitives::point_id_t i
+    , const Rules& rules
+    , const NeighborLists* neighbors = nullptr)
+{
+    return Operator::point_improvement(tour, i, [&tour, &rules](const typename Operator::Move& move)
+    {
+        return rules.template allows<Operator>(tour, move);
+    }, neighbors);
+}
+
+// Applies the first improving move around point i, if any, and queues its endpoints.
+template <typename Operator, typename Rules>
+bool point_climb(TourModifier& tour
+    , PointQueue& queue
+    , primitives::point_id_t i
+    , const Rules& rules
+    , const NeighborLists* neighbors)
+{
+    const auto move {point_improvement<Operator>(tour, i, rules, neighbors)};
+    if (move.improvement == 0)
+    {
+        return false;
+    }
+    Operator::for_each_endpoint(tour, move, [&queue](primitives::point_id_t p) { queue.push(p); });
+    rules.template apply<Operator>(tour, move);
+    return true;
+}
+
+// Climbs with all operators, but only searches moves around queued points.
+// Endpoints of every applied move are queued, so the search expands outward from the seeds
+// only as far as improvements keep appearing. Given neighbor lists, the search around a point takes O(k) instead of O(n).
+template <typename... Operator, typename Rules = Unrestricted>
+bool local_climb(OperatorSet<Operator...>
+    , TourModifier& tour
+    , PointQueue& queue
+    , const Rules& rules = {}
+    , [[maybe_unused]] const NeighborLists* neighbors = nullptr) // (unused by an empty set)
+{
+    bool improved {false};
+    while (not queue.empty())
+    {
+        [[maybe_unused]] const auto i {queue.pop()}; // (unused by an empty set)
+        // operators are tried in order until one improves.
+        improved |= (point_climb<Operator>(tour, queue, i, rules, neighbors) or ...);
+    }
+    return improved;
+}
+
+// With batch, each operator climbs with batch_climb instead of hill_climb.
+template <typename... Operator>
+void multi_climb(OperatorSet<Operator...>, TourModifier& tour, [[maybe_unused]] bool batch = false) // (unused by an empty set)
 {
     int iteration{1};
     while (true)
     {
         bool improved {false};
-        improved |= hill_climb(tour);
-        improved |= vopt::hill_climb(tour);
+        ((improved |= batch ? batch_climb<Operator>(tour) : hill_climb<Operator>(tour)), ...);
         if (constants::verbose)
         {
             auto length {tour.length()};
@@ -118,4 +176,20 @@ inline void multi_climb(TourModifier& tour)
     }
 }
 
+inline bool local_climb(TourModifier& tour
+    , PointQueue& queue
+    , const Operators& operators = {}
+    , const NeighborLists* neighbors = nullptr)
+{
+    return with_operators(operators, [&tour, &queue, neighbors](auto set)
+    {
+        return local_climb(set, tour, queue, Unrestricted{}, neighbors);
+    });
+}
+
+inline void multi_climb(TourModifier& tour, const Operators& operators = {}, bool batch = false)
+{
+    with_operators(operators, [&tour, batch](auto set) { multi_climb(set, tour, batch); });
+}
+
 } // namespace solver
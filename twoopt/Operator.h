@@ -0,0 +1,77 @@
+#pragma once
+
+// 2-opt move operator (interface described in OperatorSet.h).
+// A move (a, b) replaces segments (a, next(a)) and (b, next(b)) with (a, b) and (next(a), next(b)).
+
+#include "NeighborLists.h"
+#include "Swap.h"
+#include "TourModifier.h"
+#include "primitives.h"
+#include "twoopt/lateral.h"
+#include "twoopt/twoopt.h"
+
+#include <vector>
+
+namespace twoopt {
+
+struct Operator
+{
+    using Move = Swap;
+
+    static constexpr const char* name {"2-opt"};
+    static constexpr primitives::point_id_t removed_edge_count {2};
+
+    static Move first_improvement(const TourModifier& tour) { return twoopt::first_improvement(tour); }
+
+    static void batch_improvements(const TourModifier& tour, std::vector<Move>& moves) { twoopt::batch_improvements(tour, moves); }
+
+    template <typename Allowed>
+    static Move point_improvement(const TourModifier& tour
+        , primitives::point_id_t i
+        , const Allowed& allowed
+        , const NeighborLists* neighbors = nullptr)
+    {
+        return twoopt::point_improvement(tour, i, allowed, neighbors);
+    }
+
+    static void apply(TourModifier& tour, const Move& move) { tour.move(move.a, move.b); }
+
+    template <typename Visit>
+    static void for_each_endpoint(const TourModifier& tour, const Move& move, const Visit& visit)
+    {
+        for (auto p : {move.a, move.b, tour.next(move.a), tour.next(move.b)})
+        {
+            visit(p);
+        }
+    }
+
+    static void find_moves(const TourModifier& tour
+        , primitives::length_t cost
+        , primitives::length_t& next_cost
+        , std::vector<Move>& moves
+        , const NeighborLists* neighbors = nullptr)
+    {
+        if (neighbors)
+        {
+            lateral::find_neighbor_swaps(tour, *neighbors, cost, next_cost, moves);
+            return;
+        }
+        lateral::find_swaps(tour, cost, next_cost, moves);
+    }
+
+    template <typename Visit>
+    static void for_each_removed_edge(const TourModifier& tour, const Move& move, const Visit& visit)
+    {
+        visit(move.a, tour.next(move.a));
+        visit(move.b, tour.next(move.b));
+    }
+
+    template <typename Visit>
+    static void for_each_added_edge(const TourModifier& tour, const Move& move, const Visit& visit)
+    {
+        visit(move.a, move.b);
+        visit(tour.next(move.a), tour.next(move.b));
+    }
+};
+
+} // namespace twoopt
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "NeighborLists.h"
+#include "Swap.h"
+#include "TourModifier.h"
+#include "primitives.h"
+
+#include <algorithm> // max, min, sort, unique
+#include <vector>
+
+namespace twoopt {
+namespace lateral {
+
+inline bool is_valid_move(const TourModifier& tour
+    , primitives::point_id_t i
+    , primitives::point_id_t j
+    , primitives::length_t current_length
+    , primitives::length_t desired_cost
+    , primitives::length_t& next_cost)
+{
+    auto new_length {tour.length_map().compute_length(i, j)};
+    new_length += tour.length_map().compute_length(tour.next(i), tour.next(j));
+    const auto target_length {current_length + desired_cost};
+    if (new_length > target_length)
+    {
+        next_cost = std::min(next_cost, desired_cost + new_length - target_length);
+    }
+    return new_length == target_length;
+}
+
+// Clears swaps and fills it with the moves of the given cost.
+inline void find_swaps(const TourModifier& tour
+    , primitives::length_t cost
+    , primitives::length_t& next_cost
+    , std::vector<Swap>& swaps)
+{
+    swaps.clear();
+    constexpr primitives::point_id_t start {0};
+    // first segment cannot be compared with last segment.
+    auto end {tour.prev(start)};
+    const auto first_old_length {tour.length(start)};
+    // moves may not remove fixed segments.
+    for (primitives::point_id_t i {tour.next(tour.next(start))}; i != end and not tour.fixed(start); i = tour.next(i))
+    {
+        const auto current_length {first_old_length + tour.length(i)};
+        if (not tour.fixed(i) and is_valid_move(tour, start, i, current_length, cost, next_cost))
+        {
+            swaps.push_back({start, i, cost});
+        }
+    }
+
+    end = tour.prev(end);
+    for (primitives::point_id_t i {tour.next(start)}; i != end; i = tour.next(i))
+    {
+        if (tour.fixed(i))
+        {
+            continue;
+        }
+        const auto first_old_length {tour.length(i)};
+        for (auto j {tour.next(tour.next(i))}; j != start; j = tour.next(j))
+        {
+            const auto current_length {first_old_length + tour.length(j)};
+            if (not tour.fixed(j) and is_valid_move(tour, i, j, current_length, cost, next_cost))
+            {
+                swaps.push_back({i, j, cost});
+            }
+        }
+    }
+}
+
+// Like find_swaps, but only moves that add a segment between a point and one of its neighbors.
+inline void find_neighbor_swaps(const TourModifier& tour
+    , const NeighborLists& neighbors
+    , primitives::length_t cost
+    , primitives::length_t& next_cost
+    , std::vector<Swap>& swaps)
+{
+    swaps.clear();
+    auto consider = [&](primitives::point_id_t a, primitives::point_id_t b)
+    {
+        // the removed segments must be neither the same nor adjacent, nor fixed.
+        if (a == b or tour.next(a) == b or tour.next(b) == a or tour.fixed(a) or tour.fixed(b))
+        {
+            return;
+        }
+        if (is_valid_move(tour, a, b, tour.length(a) + tour.length(b), cost, next_cost))
+        {
+            swaps.push_back({std::min(a, b), std::max(a, b), cost});
+        }
+    };
+    for (primitives::point_id_t i {0}; i < tour.size(); ++i)
+    {
+        const auto* near {neighbors.of(i)};
+        for (primitives::point_id_t k {0}; k < neighbors.count(); ++k)
+        {
+            // (i, j) is added by the moves (i, j) and (prev(i), prev(j)).
+            const auto j {near[k]};
+            consider(i, j);
+            consider(tour.prev(i), tour.prev(j));
+        }
+    }
+    // a move adding two neighbor segments is found more than once.
+    std::sort(swaps.begin(), swaps.end(), [](const Swap& s1, const Swap& s2)
+    {
+        return s1.a < s2.a or (s1.a == s2.a and s1.b < s2.b);
+    });
+    swaps.erase(std::unique(swaps.begin(), swaps.end(), [](const Swap& s1, const Swap& s2)
+    {
+        return s1.a == s2.a and s1.b == s2.b;
+    }), swaps.end());
+}
+
+} // namespace lateral
+} // namespace twoopt
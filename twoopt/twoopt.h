@@ -0,0 +1,243 @@
+#pragma once
+
+#include "NeighborLists.h"
+#include "Swap.h"
+#include "TourModifier.h"
+#include "primitives.h"
+
+#include <algorithm> // minmax
+#include <utility> // pair
+#include <vector>
+
+namespace twoopt {
+
+inline primitives::length_t compute_improvement(const TourModifier& tour
+    , primitives::point_id_t i
+    , primitives::point_id_t j
+    , primitives::length_t current_length)
+{
+    auto new_length {tour.length_map().compute_length(i, j)};
+    if (new_length > current_length)
+    {
+        return 0;
+    }
+    new_length += tour.length_map().compute_length(tour.next(i), tour.next(j));
+    if (new_length > current_length)
+    {
+        return 0;
+    }
+    if (new_length < current_length)
+    {
+        return current_length - new_length;
+    }
+    return 0;
+}
+
+// Calls take(move) with the first improving move of each segment (i, next(i)) in turn, paired with later segments,
+// for which allowed(move) is true, until take returns true.
+template <typename Allowed, typename Take>
+void for_each_improvement(const TourModifier& tour, const Allowed& allowed, const Take& take)
+{
+    constexpr primitives::point_id_t start {0};
+    // first segment cannot be compared with last segment.
+    auto end {tour.prev(start)};
+    const auto first_old_length {tour.length(start)};
+    // moves may not remove fixed segments.
+    for (primitives::point_id_t i {tour.next(tour.next(start))}; i != end and not tour.fixed(start); i = tour.next(i))
+    {
+        if (tour.fixed(i))
+        {
+            continue;
+        }
+        const auto current_length {first_old_length + tour.length(i)};
+        const auto improvement {compute_improvement(tour, start, i, current_length)};
+        if (improvement > 0)
+        {
+            const Swap move {start, i, improvement};
+            if (allowed(move))
+            {
+                if (take(move))
+                {
+                    return;
+                }
+                break;
+            }
+        }
+    }
+
+    end = tour.prev(end);
+    for (primitives::point_id_t i {tour.next(start)}; i != end; i = tour.next(i))
+    {
+        if (tour.fixed(i))
+        {
+            continue;
+        }
+        const auto first_old_length {tour.length(i)};
+        for (auto j {tour.next(tour.next(i))}; j != start; j = tour.next(j))
+        {
+            if (tour.fixed(j))
+            {
+                continue;
+            }
+            const auto current_length {first_old_length + tour.length(j)};
+            const auto improvement {compute_improvement(tour, i, j, current_length)};
+            if (improvement > 0)
+            {
+                const Swap move {i, j, improvement};
+                if (allowed(move))
+                {
+                    if (take(move))
+                    {
+                        return;
+                    }
+                    break;
+                }
+            }
+        }
+    }
+}
+
+inline Swap first_improvement(const TourModifier& tour)
+{
+    Swap first;
+    for_each_improvement(tour, [](const Swap&) { return true; }, [&first](const Swap& move)
+    {
+        first = move;
+        return true;
+    });
+    return first;
+}
+
+// Collects improving moves that can be applied as one batch (see TourModifier::begin_batch): they touch disjoint
+// points, and no move removes one segment inside and one outside the part of the tour another move reverses,
+// so that each move still reconnects a single tour whatever the others reverse.
+inline void batch_improvements(const TourModifier& tour, std::vector<Swap>& moves)
+{
+    moves.clear();
+    const auto order {tour.order()};
+    std::vector<primitives::point_id_t> position(order.size());
+    for (primitives::point_id_t p {0}; p < order.size(); ++p)
+    {
+        position[order[p]] = p;
+    }
+    std::vector<bool> touched(order.size(), false);
+    // positions of the removed segments, first to last.
+    auto span = [&position](const Swap& move) { return std::minmax(position[move.a], position[move.b]); };
+    auto independent = [&](const Swap& move)
+    {
+        for (auto p : {move.a, tour.next(move.a), move.b, tour.next(move.b)})
+        {
+            if (touched[p])
+            {
+                return false;
+            }
+        }
+        const auto [first, last] {span(move)};
+        for (const auto& other : moves)
+        {
+            const auto [other_first, other_last] {span(other)};
+            const bool interleaved {(first < other_first and other_first < last and last < other_last)
+                or (other_first < first and first < other_last and other_last < last)};
+            if (interleaved)
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+    for_each_improvement(tour, independent, [&](const Swap& move)
+    {
+        for (auto p : {move.a, tour.next(move.a), move.b, tour.next(move.b)})
+        {
+            touched[p] = true;
+        }
+        moves.push_back(move);
+        return false;
+    });
+}
+
+// Searches only moves that remove the segment (a, next(a)), returning the first improving move
+// for which allowed(move) is true.
+template <typename Allowed>
+Swap segment_improvement(const TourModifier& tour, primitives::point_id_t a, const Allowed& allowed)
+{
+    if (tour.fixed(a))
+    {
+        return {};
+    }
+    const auto first_old_length {tour.length(a)};
+    const auto end {tour.prev(a)};
+    for (primitives::point_id_t j {tour.next(tour.next(a))}; j != end; j = tour.next(j))
+    {
+        if (tour.fixed(j))
+        {
+            continue;
+        }
+        const auto current_length {first_old_length + tour.length(j)};
+        const auto improvement {compute_improvement(tour, a, j, current_length)};
+        if (improvement > 0)
+        {
+            const Swap move {a, j, improvement};
+            if (allowed(move))
+            {
+                return move;
+            }
+        }
+    }
+    return {};
+}
+
+// Searches only moves that add a segment between point i and one of its neighbors, in O(k) instead of O(n).
+template <typename Allowed>
+Swap neighbor_improvement(const TourModifier& tour
+    , primitives::point_id_t i
+    , const NeighborLists& neighbors
+    , const Allowed& allowed)
+{
+    auto improvement = [&tour](primitives::point_id_t a, primitives::point_id_t b) -> primitives::length_t
+    {
+        // the removed segments must be neither the same nor adjacent, nor fixed.
+        if (a == b or tour.next(a) == b or tour.next(b) == a or tour.fixed(a) or tour.fixed(b))
+        {
+            return 0;
+        }
+        return compute_improvement(tour, a, b, tour.length(a) + tour.length(b));
+    };
+    const auto* near {neighbors.of(i)};
+    for (primitives::point_id_t k {0}; k < neighbors.count(); ++k)
+    {
+        // (i, j) is added by the moves (i, j) and (prev(i), prev(j)).
+        const auto j {near[k]};
+        for (const auto& [a, b] : {std::pair{i, j}, std::pair{tour.prev(i), tour.prev(j)}})
+        {
+            const Swap move {a, b, improvement(a, b)};
+            if (move.improvement > 0 and allowed(move))
+            {
+                return move;
+            }
+        }
+    }
+    return {};
+}
+
+// Searches only moves that remove a segment adjacent to point i;
+// given neighbor lists, only those adding a segment between i and one of its neighbors.
+template <typename Allowed>
+Swap point_improvement(const TourModifier& tour
+    , primitives::point_id_t i
+    , const Allowed& allowed
+    , const NeighborLists* neighbors = nullptr)
+{
+    if (neighbors)
+    {
+        return neighbor_improvement(tour, i, *neighbors, allowed);
+    }
+    const auto move {segment_improvement(tour, i, allowed)};
+    if (move.improvement > 0)
+    {
+        return move;
+    }
+    return segment_improvement(tour, tour.prev(i), allowed);
+}
+
+} // namespace twoopt
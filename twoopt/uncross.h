@@ -0,0 +1,170 @@
+#pragma once
+
+// Removes crossing segments with 2-opt moves. In the plane, replacing two crossing segments (a, next(a)) and
+// (b, next(b)) with (a, b) and (next(a), next(b)) always shortens the tour, and crossings are found through a
+// grid of the tour segments instead of by enumerating pairs, so this untangles an arbitrary initial tour
+// far faster than a climb. Only for instances whose lengths are distances between their coordinates.
+// The moves are applied to the tour order in an array (see ArrayTour), and the tour is rebuilt once at the end.
+
+#include "FixedEdges.h"
+#include "Instance.h"
+#include "PointQueue.h"
+#include "SegmentGrid.h"
+#include "TourModifier.h"
+#include "constants.h"
+#include "primitives.h"
+
+#include <cstddef> // size_t
+#include <cstdlib> // abort
+#include <iostream>
+#include <utility> // swap
+#include <vector>
+
+namespace twoopt {
+namespace uncross {
+
+// Tour order with the position of every point, for applying many 2-opt moves without the O(n) orientation
+// update of TourModifier after each: a move reverses the shorter of the two paths it reconnects.
+class ArrayTour
+{
+public:
+    explicit ArrayTour(std::vector<primitives::point_id_t> order)
+        : m_order(std::move(order))
+        , m_position(m_order.size())
+    {
+        for (primitives::point_id_t i {0}; i < m_order.size(); ++i)
+        {
+            m_position[m_order[i]] = i;
+        }
+    }
+
+    primitives::point_id_t next(primitives::point_id_t p) const
+    {
+        const auto i {m_position[p] + 1};
+        return m_order[i == m_order.size() ? 0 : i];
+    }
+    primitives::point_id_t prev(primitives::point_id_t p) const
+    {
+        const auto i {m_position[p]};
+        return m_order[i == 0 ? m_order.size() - 1 : i - 1];
+    }
+    const std::vector<primitives::point_id_t>& order() const { return m_order; }
+
+    // Replaces (a, next(a)) and (b, next(b)) with (a, b) and (next(a), next(b)),
+    // by reversing either the path from next(a) to b or the one from next(b) to a.
+    void move(primitives::point_id_t a, primitives::point_id_t b)
+    {
+        const size_t n {m_order.size()};
+        size_t first {m_position[a] + 1};
+        size_t count {(m_position[b] + n - m_position[a]) % n};
+        if (2 * count > n)
+        {
+            first = m_position[b] + 1;
+            count = n - count;
+        }
+        for (size_t k {0}; k < count / 2; ++k)
+        {
+            const auto i {(first + k) % n};
+            const auto j {(first + count - 1 - k) % n};
+            std::swap(m_order[i], m_order[j]);
+            m_position[m_order[i]] = i;
+            m_position[m_order[j]] = j;
+        }
+    }
+
+private:
+    std::vector<primitives::point_id_t> m_order;
+    std::vector<primitives::point_id_t> m_position;
+};
+
+// Applies the move removing (a, next(a)) and a segment crossing it, if there is one that shortens the tour,
+// and queues the points of both segments. Moves may not remove fixed edges, if given.
+inline bool uncross_segment(ArrayTour& tour
+    , const Instance& instance
+    , const FixedEdges* fixed
+    , SegmentGrid& grid
+    , PointQueue& queue
+    , primitives::point_id_t a)
+{
+    auto is_fixed = [&tour, fixed](primitives::point_id_t p) { return fixed and fixed->contains(p, tour.next(p)); };
+    if (is_fixed(a))
+    {
+        return false;
+    }
+    const auto next_a {tour.next(a)};
+    // the point of a segment that comes first in tour order.
+    auto first = [&tour](primitives::point_id_t c, primitives::point_id_t d) { return tour.next(c) == d ? c : d; };
+    const auto crossing {grid.find_crossing(a, next_a, [&](primitives::point_id_t c, primitives::point_id_t d)
+    {
+        // lengths are rounded, so the move may not be shorter after all.
+        const auto b {first(c, d)};
+        if (is_fixed(b))
+        {
+            return false;
+        }
+        const auto current_length {instance.length(a, next_a) + instance.length(b, tour.next(b))};
+        const auto new_length {instance.length(a, b) + instance.length(next_a, tour.next(b))};
+        return new_length < current_length;
+    })};
+    if (crossing.first == constants::invalid_point)
+    {
+        return false;
+    }
+    const auto b {first(crossing.first, crossing.second)};
+    const auto next_b {tour.next(b)};
+    grid.erase(a, next_a);
+    grid.erase(b, next_b);
+    tour.move(a, b);
+    grid.insert(a, b);
+    grid.insert(next_a, next_b);
+    for (auto p : {a, next_a, b, next_b})
+    {
+        queue.push(p);
+    }
+    return true;
+}
+
+// Returns the number of moves applied. The tour is rebuilt rather than moved, so it may not have a journal.
+inline size_t remove_crossings(TourModifier& tour)
+{
+    const auto& instance {*tour.instance()};
+    const primitives::point_id_t n = tour.size();
+    if (not instance.grid() or n < 4)
+    {
+        return 0;
+    }
+    if (tour.journal())
+    {
+        std::cout << __func__ << ": error: the moves would not be journaled." << std::endl;
+        std::abort();
+    }
+    ArrayTour array(tour.order());
+    const auto fixed {tour.fixed()};
+    SegmentGrid grid(instance.x(), instance.y());
+    PointQueue queue(n);
+    for (primitives::point_id_t i {0}; i < n; ++i)
+    {
+        grid.insert(i, array.next(i));
+        queue.push(i);
+    }
+    size_t moves {0};
+    while (not queue.empty())
+    {
+        const auto p {queue.pop()};
+        // moves reverse parts of the tour, so a queued point may now start either of its segments.
+        if (uncross_segment(array, instance, fixed.get(), grid, queue, p)
+            or uncross_segment(array, instance, fixed.get(), grid, queue, array.prev(p)))
+        {
+            ++moves;
+        }
+    }
+    if (moves > 0)
+    {
+        tour.reset(array.order(), tour.instance());
+        tour.set_fixed(fixed);
+    }
+    return moves;
+}
+
+} // namespace uncross
+} // namespace twoopt
@@ -0,0 +1,79 @@
+#pragma once
+
+// v-opt move operator (interface described in OperatorSet.h).
+// A move (v, n) relocates vertex v into the segment (n, next(n)).
+
+#include "Swap.h"
+#include "lateral.h"
+#include "vopt.h"
+#include <NeighborLists.h>
+#include <TourModifier.h>
+#include <primitives.h>
+
+#include <vector>
+
+namespace vopt {
+
+struct Operator
+{
+    using Move = Swap;
+
+    static constexpr const char* name {"v-opt"};
+    static constexpr primitives::point_id_t removed_edge_count {3};
+
+    static Move first_improvement(const TourModifier& tour) { return vopt::first_improvement(tour); }
+
+    static void batch_improvements(const TourModifier& tour, std::vector<Move>& moves) { vopt::batch_improvements(tour, moves); }
+
+    template <typename Allowed>
+    static Move point_improvement(const TourModifier& tour
+        , primitives::point_id_t p
+        , const Allowed& allowed
+        , const NeighborLists* neighbors = nullptr)
+    {
+        return vopt::point_improvement(tour, p, allowed, neighbors);
+    }
+
+    static void apply(TourModifier& tour, const Move& move) { tour.vmove(move.v, move.n); }
+
+    template <typename Visit>
+    static void for_each_endpoint(const TourModifier& tour, const Move& move, const Visit& visit)
+    {
+        for (auto p : {move.v, tour.prev(move.v), tour.next(move.v), move.n, tour.next(move.n)})
+        {
+            visit(p);
+        }
+    }
+
+    static void find_moves(const TourModifier& tour
+        , primitives::length_t cost
+        , primitives::length_t& next_cost
+        , std::vector<Move>& moves
+        , const NeighborLists* neighbors = nullptr)
+    {
+        if (neighbors)
+        {
+            lateral::find_neighbor_swaps(tour, *neighbors, cost, next_cost, moves);
+            return;
+        }
+        lateral::find_swaps(tour, cost, next_cost, moves);
+    }
+
+    template <typename Visit>
+    static void for_each_removed_edge(const TourModifier& tour, const Move& move, const Visit& visit)
+    {
+        visit(tour.prev(move.v), move.v);
+        visit(move.v, tour.next(move.v));
+        visit(move.n, tour.next(move.n));
+    }
+
+    template <typename Visit>
+    static void for_each_added_edge(const TourModifier& tour, const Move& move, const Visit& visit)
+    {
+        visit(tour.prev(move.v), tour.next(move.v));
+        visit(move.n, move.v);
+        visit(move.v, tour.next(move.n));
+    }
+};
+
+} // namespace vopt
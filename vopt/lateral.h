@@ -1,11 +1,13 @@
 #pragma once
 
-#include <Pair.h>
 #include "Swap.h"
-#include "TourModifier.h"
-#include "solver.h"
+#include "vopt.h"
+#include <NeighborLists.h>
+#include <TourModifier.h>
+#include <primitives.h>
 
-#include <algorithm> // min
+#include <algorithm> // min, sort, unique
+#include <vector>
 
 namespace vopt {
 namespace lateral {
@@ -29,113 +31,74 @@ inline bool is_valid_move(const TourModifier& tour
     return known_new_length == target_length;
 }
 
-inline std::vector<Swap> find_swaps(const TourModifier& tour
+// Clears swaps and fills it with the moves of the given cost.
+inline void find_swaps(const TourModifier& tour
     , primitives::length_t cost
-    , primitives::length_t& next_cost)
+    , primitives::length_t& next_cost
+    , std::vector<Swap>& swaps)
 {
-    std::vector<Swap> swaps;
+    swaps.clear();
     constexpr primitives::point_id_t v_start {0};
     // the only restrictions on comparison with point p is prev(p) and p itself.
     primitives::point_id_t v {v_start};
     do
     {
         const auto start {tour.next(v)};
-        const auto end {tour.prev(v)};
+        // moves may not remove fixed segments.
+        const auto end {movable(tour, v) ? tour.prev(v) : start};
         const auto known_new_length {tour.length_map().compute_length(tour.prev(v), tour.next(v))};
         const auto known_current_length {tour.length(v) + tour.prev_length(v)};
         for (primitives::point_id_t n {start}; n != end; n = tour.next(n))
         {
-            if (is_valid_move(tour, v, n, known_current_length, known_new_length, cost, next_cost))
+            if (not tour.fixed(n) and is_valid_move(tour, v, n, known_current_length, known_new_length, cost, next_cost))
             {
                 swaps.push_back({v, n, cost});
             }
         }
         v = tour.next(v);
     } while (v != v_start);
-    return swaps;
 }
 
-inline Swap restricted_first_improvement(const TourModifier& tour, const primitives::point_id_t v_restriction, const Segment& join_restriction)
+// Like find_swaps, but only moves that insert v next to one of its neighbors.
+inline void find_neighbor_swaps(const TourModifier& tour
+    , const NeighborLists& neighbors
+    , primitives::length_t cost
+    , primitives::length_t& next_cost
+    , std::vector<Swap>& swaps)
 {
-    constexpr primitives::point_id_t v_start {0};
-    // the only restrictions on comparison with point p is prev(p) and p itself.
-    primitives::point_id_t v {v_start};
-    do
+    swaps.clear();
+    for (primitives::point_id_t v {0}; v < tour.size(); ++v)
     {
-        const auto start {tour.next(v)};
-        const auto end {tour.prev(v)};
-        const auto known_new_length {tour.length_map().compute_length(tour.prev(v), tour.next(v))};
+        if (not movable(tour, v))
+        {
+            continue;
+        }
+        const auto prev_v {tour.prev(v)};
+        const auto known_new_length {tour.length_map().compute_length(prev_v, tour.next(v))};
         const auto known_current_length {tour.length(v) + tour.prev_length(v)};
-        for (primitives::point_id_t n {start}; n != end; n = tour.next(n))
+        const auto* near {neighbors.of(v)};
+        for (primitives::point_id_t k {0}; k < neighbors.count(); ++k)
         {
-            const auto improvement {compute_improvement(tour, v, n, known_current_length, known_new_length)};
-            if (improvement > 0)
+            // segments (near, next(near)) and (prev(near), near); those of v cannot take v.
+            for (auto n : {near[k], tour.prev(near[k])})
             {
-                const Segment deletion(n, tour.next(n));
-                if (v != v_restriction or join_restriction != deletion)
+                if (n != v and n != prev_v and not tour.fixed(n)
+                    and is_valid_move(tour, v, n, known_current_length, known_new_length, cost, next_cost))
                 {
-                    return {v, n, improvement};
+                    swaps.push_back({v, n, cost});
                 }
             }
         }
-        v = tour.next(v);
-    } while (v != v_start);
-    return {};
-}
-
-inline TourModifier perturbation_climb(const std::vector<Swap>& swaps, const TourModifier& tour)
-{
-    const auto original_length {tour.length()};
-    for (const auto& swap : swaps)
-    {
-        auto new_tour = tour;
-        new_tour.vmove(swap.v, swap.n);
-        const Segment join_restriction(tour.prev(swap.v), tour.next(swap.v));
-        while (true)
-        {
-            const auto new_swap {restricted_first_improvement(new_tour, swap.v, join_restriction)};
-            if (new_swap.improvement == 0)
-            {
-                break;
-            }
-            new_tour.vmove(new_swap.v, new_swap.n);
-        }
-        solver::multi_climb(new_tour);
-        if (new_tour.length() < original_length)
-        {
-            return new_tour;
-        }
     }
-    return tour;
-}
-
-inline TourModifier perturbation_climb(const TourModifier& tour, primitives::length_t cost, primitives::length_t& next_cost)
-{
-    const auto swaps {find_swaps(tour, cost, next_cost)};
-    return perturbation_climb(swaps, tour);
-}
-
-inline TourModifier perturbation_climb(const TourModifier& tour)
-{
-    const auto original_length {tour.length()};
-    primitives::length_t current_cost {0};
-    while (true)
+    // a segment between two neighbors is found from both.
+    std::sort(swaps.begin(), swaps.end(), [](const Swap& s1, const Swap& s2)
     {
-        std::cout << "trying perturbation cost: " << current_cost << std::endl;
-        primitives::length_t next_cost {constants::invalid_length};
-        const auto new_tour {perturbation_climb(tour, current_cost, next_cost)};
-        if (new_tour.length() < original_length)
-        {
-            return new_tour;
-        }
-        if (next_cost == constants::invalid_length)
-        {
-            break;
-        }
-        current_cost = next_cost;
-    }
-    std::cout << "No more perturbations left to try." << std::endl;
-    return tour;
+        return s1.v < s2.v or (s1.v == s2.v and s1.n < s2.n);
+    });
+    swaps.erase(std::unique(swaps.begin(), swaps.end(), [](const Swap& s1, const Swap& s2)
+    {
+        return s1.v == s2.v and s1.n == s2.n;
+    }), swaps.end());
 }
 
 } // namespace lateral
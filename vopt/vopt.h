@@ -1,10 +1,13 @@
 #pragma once
 
 #include "Swap.h"
+#include <NeighborLists.h>
 #include <TourModifier.h>
-#include <constants.h>
 #include <primitives.h>
 
+#include <algorithm> // max
+#include <array>
+#include <utility> // pair
 #include <vector>
 
 namespace vopt {
@@ -33,7 +36,17 @@ inline primitives::length_t compute_improvement(const TourModifier& tour
     return known_current_length - known_new_length;
 }
 
-inline Swap first_improvement(const TourModifier& tour)
+// Whether moves may relocate v, which removes both of its segments (fixed segments may not be removed).
+inline bool movable(const TourModifier& tour, primitives::point_id_t v)
+{
+    return not tour.fixed(v) and not tour.fixed(tour.prev(v));
+}
+
+// Searches all segments for every vertex; used when the instance has no spatial index.
+// Calls take(move) with the first improving move of each vertex in turn for which allowed(move) is true,
+// until take returns true.
+template <typename Allowed, typename Take>
+void scan_improvements(const TourModifier& tour, const Allowed& allowed, const Take& take)
 {
     constexpr primitives::point_id_t v_start {0};
     // the only restrictions on comparison with point p is prev(p) and p itself.
@@ -41,51 +54,268 @@ inline Swap first_improvement(const TourModifier& tour)
     do
     {
         const auto start {tour.next(v)};
-        const auto end {tour.prev(v)};
+        // no segments to search if v is not movable.
+        const auto end {movable(tour, v) ? tour.prev(v) : start};
         const auto known_new_length {tour.length_map().compute_length(tour.prev(v), tour.next(v))};
         const auto known_current_length {tour.length(v) + tour.prev_length(v)};
         for (primitives::point_id_t n {start}; n != end; n = tour.next(n))
         {
+            if (tour.fixed(n))
+            {
+                continue;
+            }
             const auto improvement {compute_improvement(tour, v, n, known_current_length, known_new_length)};
             if (improvement > 0)
             {
-                return {v, n, improvement};
+                const Swap move {v, n, improvement};
+                if (allowed(move))
+                {
+                    if (take(move))
+                    {
+                        return;
+                    }
+                    break;
+                }
+            }
+        }
+        v = tour.next(v);
+    } while (v != v_start);
+}
+
+inline primitives::length_t longest_length(const TourModifier& tour)
+{
+    primitives::length_t longest {0};
+    for (primitives::point_id_t i {0}; i < tour.size(); ++i)
+    {
+        longest = std::max(longest, tour.length(i));
+    }
+    return longest;
+}
+
+// Inserting v into (n, next(n)) only improves if v is within (gain + length(n)) / 2 of n or next(n),
+// where gain is the length saved by removing v: otherwise the two new segments add more than that.
+// So only segments with an endpoint near v are searched, through the spatial index of the instance.
+// Same calls as scan_improvements.
+template <typename Allowed, typename Take>
+void for_each_improvement(const TourModifier& tour, const Allowed& allowed, const Take& take)
+{
+    const auto* grid {tour.instance()->grid()};
+    if (not grid)
+    {
+        scan_improvements(tour, allowed, take);
+        return;
+    }
+    // with long segments (e.g. in an initial tour) the searched areas would cover most points anyway.
+    const auto longest {longest_length(tour)};
+    constexpr double pi {3.14159265358979323846};
+    if (pi * longest * longest / 4 > grid->area() / 2)
+    {
+        scan_improvements(tour, allowed, take);
+        return;
+    }
+    constexpr primitives::point_id_t v_start {0};
+    primitives::point_id_t v {v_start};
+    do
+    {
+        const auto prev_v {tour.prev(v)};
+        const auto known_new_length {tour.length_map().compute_length(prev_v, tour.next(v))};
+        const auto known_current_length {tour.length(v) + tour.prev_length(v)};
+        if (known_new_length < known_current_length and movable(tour, v))
+        {
+            const auto gain {known_current_length - known_new_length};
+            // lengths are rounded distances, hence the margin.
+            const auto radius {(gain + longest) / 2.0 + 1};
+            Swap move;
+            grid->within(v, radius, [&](primitives::point_id_t near)
+            {
+                // segments (near, next(near)) and (prev(near), near); those of v cannot take v.
+                for (auto n : {near, tour.prev(near)})
+                {
+                    if (n == v or n == prev_v or tour.fixed(n))
+                    {
+                        continue;
+                    }
+                    const auto improvement {compute_improvement(tour, v, n, known_current_length, known_new_length)};
+                    if (improvement > 0 and allowed(Swap{v, n, improvement}))
+                    {
+                        move = {v, n, improvement};
+                        return true;
+                    }
+                }
+                return false;
+            });
+            if (move.improvement > 0 and take(move))
+            {
+                return;
             }
         }
         v = tour.next(v);
     } while (v != v_start);
+}
+
+inline Swap first_improvement(const TourModifier& tour)
+{
+    Swap first;
+    for_each_improvement(tour, [](const Swap&) { return true; }, [&first](const Swap& move)
+    {
+        first = move;
+        return true;
+    });
+    return first;
+}
+
+// Collects improving moves that touch disjoint points, which can be applied as one batch
+// (see TourModifier::begin_batch): relocations do not depend on the orientation of the rest of the tour.
+inline void batch_improvements(const TourModifier& tour, std::vector<Swap>& moves)
+{
+    moves.clear();
+    std::vector<bool> touched(tour.size(), false);
+    auto endpoints = [&tour](const Swap& move)
+    {
+        return std::array<primitives::point_id_t, 5>{move.v, tour.prev(move.v), tour.next(move.v), move.n, tour.next(move.n)};
+    };
+    for_each_improvement(tour, [&](const Swap& move)
+    {
+        for (auto p : endpoints(move))
+        {
+            if (touched[p])
+            {
+                return false;
+            }
+        }
+        return true;
+    }, [&](const Swap& move)
+    {
+        for (auto p : endpoints(move))
+        {
+            touched[p] = true;
+        }
+        moves.push_back(move);
+        return false;
+    });
+}
+
+// Searches only moves that relocate v, returning the first improving move for which allowed(move) is true.
+template <typename Allowed>
+Swap vertex_improvement(const TourModifier& tour, primitives::point_id_t v, const Allowed& allowed)
+{
+    if (not movable(tour, v))
+    {
+        return {};
+    }
+    const auto start {tour.next(v)};
+    const auto end {tour.prev(v)};
+    const auto known_new_length {tour.length_map().compute_length(tour.prev(v), tour.next(v))};
+    const auto known_current_length {tour.length(v) + tour.prev_length(v)};
+    for (primitives::point_id_t n {start}; n != end; n = tour.next(n))
+    {
+        if (tour.fixed(n))
+        {
+            continue;
+        }
+        const auto improvement {compute_improvement(tour, v, n, known_current_length, known_new_length)};
+        if (improvement > 0)
+        {
+            const Swap move {v, n, improvement};
+            if (allowed(move))
+            {
+                return move;
+            }
+        }
+    }
     return {};
 }
 
-inline bool hill_climb(TourModifier& tour)
+// Searches only moves that insert some vertex into the segment (n, next(n)).
+template <typename Allowed>
+Swap insertion_improvement(const TourModifier& tour, primitives::point_id_t n, const Allowed& allowed)
 {
-    bool improved {false};
-    auto move {first_improvement(tour)};
-    if (move.improvement > 0)
+    if (tour.fixed(n))
     {
-        improved = true;
+        return {};
     }
-    int iteration{1};
-    while (move.improvement > 0)
+    // v cannot be n or next(n).
+    const auto end {n};
+    for (primitives::point_id_t v {tour.next(tour.next(n))}; v != end; v = tour.next(v))
     {
-        tour.vmove(move.v, move.n);
-        if (constants::verbose)
+        if (not movable(tour, v))
         {
-            auto length {tour.length()};
-            std::cout << "Iteration " << iteration
-                << " tour length: " << length
-                << " (step improvement: " << move.improvement << ")\n";
+            continue;
         }
-        move = first_improvement(tour);
-        if (move.improvement > 0)
+        const auto known_new_length {tour.length_map().compute_length(tour.prev(v), tour.next(v))};
+        const auto known_current_length {tour.length(v) + tour.prev_length(v)};
+        const auto improvement {compute_improvement(tour, v, n, known_current_length, known_new_length)};
+        if (improvement > 0)
         {
-            improved = true;
+            const Swap move {v, n, improvement};
+            if (allowed(move))
+            {
+                return move;
+            }
         }
-        ++iteration;
     }
-    return improved;
+    return {};
 }
 
-} // namespace vopt
+// Searches only moves that put point p next to one of its neighbors or one of its neighbors next to p,
+// in O(k) instead of O(n).
+template <typename Allowed>
+Swap neighbor_improvement(const TourModifier& tour
+    , primitives::point_id_t p
+    , const NeighborLists& neighbors
+    , const Allowed& allowed)
+{
+    auto improvement = [&tour](primitives::point_id_t v, primitives::point_id_t n) -> primitives::length_t
+    {
+        // segments of v cannot take v.
+        if (n == v or n == tour.prev(v) or not movable(tour, v) or tour.fixed(n))
+        {
+            return 0;
+        }
+        const auto known_new_length {tour.length_map().compute_length(tour.prev(v), tour.next(v))};
+        const auto known_current_length {tour.length(v) + tour.prev_length(v)};
+        return compute_improvement(tour, v, n, known_current_length, known_new_length);
+    };
+    const auto* near {neighbors.of(p)};
+    for (primitives::point_id_t k {0}; k < neighbors.count(); ++k)
+    {
+        // p into (near, next(near)) or (prev(near), near), and near into the segments of p.
+        const auto q {near[k]};
+        for (const auto& [v, n] : {std::pair{p, q}, std::pair{p, tour.prev(q)}, std::pair{q, p}, std::pair{q, tour.prev(p)}})
+        {
+            const Swap move {v, n, improvement(v, n)};
+            if (move.improvement > 0 and allowed(move))
+            {
+                return move;
+            }
+        }
+    }
+    return {};
+}
 
+// Searches only moves that relocate point p or insert a vertex into a segment adjacent to p;
+// given neighbor lists, only those that put p and one of its neighbors side by side.
+template <typename Allowed>
+Swap point_improvement(const TourModifier& tour
+    , primitives::point_id_t p
+    , const Allowed& allowed
+    , const NeighborLists* neighbors = nullptr)
+{
+    if (neighbors)
+    {
+        return neighbor_improvement(tour, p, *neighbors, allowed);
+    }
+    auto move {vertex_improvement(tour, p, allowed)};
+    if (move.improvement > 0)
+    {
+        return move;
+    }
+    move = insertion_improvement(tour, p, allowed);
+    if (move.improvement > 0)
+    {
+        return move;
+    }
+    return insertion_improvement(tour, tour.prev(p), allowed);
+}
 
+} // namespace vopt